@@ -0,0 +1,253 @@
+#include "include/cache_buffer.hpp"
+
+using namespace duckdb;
+
+// Term of a row in a column read from a parsed chunk; false for NULL
+static bool GetTerm(const UnifiedVectorFormat &format, idx_t row, const char *&data, idx_t &len) {
+	auto idx = format.sel->get_index(row);
+	if (!format.validity.RowIsValid(idx)) {
+		data = nullptr;
+		len = 0;
+		return false;
+	}
+	auto &term = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+	data = term.GetData();
+	len = term.GetSize();
+	return true;
+}
+
+CacheBuffer::CacheBuffer(FileSystem &fs, const std::string &cache_path, const ParseCacheKey &key, idx_t group_start,
+                         idx_t group_end)
+    : ITriplesBuffer(key.path, ""), _group_next(group_start), _group_end(group_end) {
+	_cache = ParseCacheFile::Open(fs, cache_path, key);
+	if (!_cache || group_end > _cache->GroupCount()) {
+		throw std::runtime_error("The parse cache of " + key.path + " changed during the scan");
+	}
+}
+
+CacheBuffer::CacheBuffer(std::unique_ptr<ITriplesBuffer> inner, FileSystem &fs, const std::string &cache_path,
+                         const ParseCacheKey &key)
+    : ITriplesBuffer(key.path, ""), _inner(std::move(inner)) {
+	// The cache holds every statement: projection and filters are applied here, after caching
+	duckdb::vector<column_t> all_columns {0, 1, 2, 3, 4, 5};
+	_inner->SetColumnIds(all_columns);
+	duckdb::vector<LogicalType> types(CacheRowGroup::COLUMN_COUNT, LogicalType::VARCHAR);
+	_parsed.Initialize(Allocator::DefaultAllocator(), types);
+	try {
+		_writer = make_uniq<ParseCacheWriter>(fs, cache_path, key);
+	} catch (std::exception &) {
+		// cache_dir is not writable: the file is parsed as if no cache had been asked for
+	}
+}
+
+void CacheBuffer::StartParse() {
+	if (_inner) {
+		_inner->StartParse();
+	}
+}
+
+void CacheBuffer::Prefetch() {
+	if (_inner) {
+		_inner->Prefetch();
+	}
+}
+
+idx_t CacheBuffer::BytesRead() const {
+	return _inner ? _inner->BytesRead() : _cache_bytes_read;
+}
+
+void CacheBuffer::PopulateChunk(DataChunk &output) {
+	if (_filter) {
+		_filter->Refresh();
+	}
+	if (_inner) {
+		PopulateFromParse(output);
+	} else {
+		PopulateFromCache(output);
+	}
+}
+
+bool CacheBuffer::NextGroup() {
+	if (_group_next >= _group_end) {
+		return false;
+	}
+	bool typed = _typed != nullptr;
+	bool columns[CacheRowGroup::COLUMN_COUNT];
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		columns[col] =
+		    _output_slot[col] >= 0 || (_filter && _filter->HasFilter(col)) || (typed && (col == 3 || col == 4));
+	}
+	_group = _cache->ReadGroup(_group_next, columns);
+	_cache_bytes_read += _cache->GroupSize(_group_next);
+	_group_next++;
+	_group_row = 0;
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		_memo[col].assign(_filter && _filter->HasFilter(col) ? _group->term_count[col] : 0, 0);
+	}
+	_kinds.assign(typed ? _group->term_count[4] : 0, RDFObjectKind::NONE);
+	if (typed) {
+		auto datatypes = FlatVector::GetData<string_t>(*_group->terms[4]);
+		for (idx_t i = 1; i < _kinds.size(); i++) {
+			_kinds[i] = ClassifyDatatype(datatypes[i].GetData(), datatypes[i].GetSize());
+		}
+	}
+	return true;
+}
+
+bool CacheBuffer::TermMatches(idx_t col, uint32_t idx) {
+	auto &memo = _memo[col][idx];
+	if ((memo >> 1) != _generation) {
+		auto &term = FlatVector::GetData<string_t>(*_group->terms[col])[idx];
+		bool matches = idx == 0 ? _filter->Matches(col, nullptr, 0)
+		                        : _filter->Matches(col, term.GetData(), term.GetSize());
+		memo = (_generation << 1) | (matches ? 1 : 0);
+	}
+	return memo & 1;
+}
+
+void CacheBuffer::PopulateFromCache(DataChunk &output) {
+	// Dynamic filters may have changed since the last chunk, so memoized results start over
+	_generation++;
+	uint32_t rows[STANDARD_VECTOR_SIZE];
+	idx_t count = 0;
+	// A chunk holds rows of one group, so its columns can be dictionaries over the group's terms
+	while (count == 0) {
+		if ((!_group || _group_row >= _group->count) && !NextGroup()) {
+			output.SetCardinality(0);
+			return;
+		}
+		for (; _group_row < _group->count && count < STANDARD_VECTOR_SIZE; _group_row++) {
+			auto row = (uint32_t)_group_row;
+			if (_filter) {
+				bool matches = true;
+				for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT && matches; col++) {
+					matches = !_filter->HasFilter(col) || TermMatches(col, _group->indices[col][row]);
+				}
+				if (!matches) {
+					continue;
+				}
+			}
+			rows[count++] = row;
+		}
+	}
+
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		if (_output_slot[col] < 0) {
+			continue;
+		}
+		auto &indices = _group->indices[col];
+		SelectionVector sel(count);
+		for (idx_t i = 0; i < count; i++) {
+			sel.set_index(i, indices[rows[i]]);
+		}
+		output.data[_output_slot[col]].Slice(*_group->terms[col], sel, count);
+	}
+	if (_typed) {
+		auto objects = FlatVector::GetData<string_t>(*_group->terms[3]);
+		for (idx_t i = 0; i < count; i++) {
+			auto kind = _kinds[_group->indices[4][rows[i]]];
+			auto object_idx = _group->indices[3][rows[i]];
+			if (kind != RDFObjectKind::NONE && object_idx != 0) {
+				_typed->Add(i, kind, objects[object_idx].GetData(), objects[object_idx].GetSize());
+			}
+		}
+		_typed->Decode(output, _output_slot + TypedObjectBatch::FIRST_COLUMN, 0, count);
+	}
+	output.SetCardinality(count);
+}
+
+void CacheBuffer::CacheChunk(DataChunk &chunk) {
+	if (!_writer) {
+		return;
+	}
+	try {
+		_builder.Append(chunk);
+		if (_builder.Count() >= CacheRowGroupBuilder::ROW_GROUP_SIZE) {
+			_writer->WriteGroup(_builder.Serialize());
+		}
+	} catch (std::exception &) {
+		// A failed cache write (a full disk) only costs the next scan a parse
+		_writer.reset();
+	}
+}
+
+void CacheBuffer::PopulateFromParse(DataChunk &output) {
+	while (true) {
+		_parsed.Reset();
+		_inner->PopulateChunk(_parsed);
+		auto count = _parsed.size();
+		if (count == 0) {
+			// The whole file has been parsed: publish its cache
+			if (_writer) {
+				try {
+					if (_builder.Count() > 0) {
+						_writer->WriteGroup(_builder.Serialize());
+					}
+					_writer->Finish();
+				} catch (std::exception &) {
+				}
+				_writer.reset();
+			}
+			output.SetCardinality(0);
+			return;
+		}
+		CacheChunk(_parsed);
+
+		bool typed = _typed != nullptr;
+		UnifiedVectorFormat formats[CacheRowGroup::COLUMN_COUNT];
+		for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+			if ((_filter && _filter->HasFilter(col)) || (typed && (col == 3 || col == 4))) {
+				_parsed.data[col].ToUnifiedFormat(count, formats[col]);
+			}
+		}
+		SelectionVector sel(count);
+		idx_t selected = 0;
+		const char *data;
+		idx_t len;
+		for (idx_t row = 0; row < count; row++) {
+			if (_filter) {
+				bool matches = true;
+				for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT && matches; col++) {
+					if (_filter->HasFilter(col)) {
+						GetTerm(formats[col], row, data, len);
+						matches = _filter->Matches(col, data, len);
+					}
+				}
+				if (!matches) {
+					continue;
+				}
+			}
+			sel.set_index(selected++, row);
+		}
+		if (selected == 0) {
+			continue;
+		}
+
+		for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+			if (_output_slot[col] < 0) {
+				continue;
+			}
+			auto &target = output.data[_output_slot[col]];
+			if (selected == count) {
+				target.Reference(_parsed.data[col]);
+			} else {
+				target.Slice(_parsed.data[col], sel, selected);
+			}
+		}
+		if (_typed) {
+			for (idx_t i = 0; i < selected; i++) {
+				auto row = sel.get_index(i);
+				if (!GetTerm(formats[4], row, data, len)) {
+					continue;
+				}
+				auto kind = ClassifyDatatype(data, len);
+				if (kind != RDFObjectKind::NONE && GetTerm(formats[3], row, data, len)) {
+					_typed->Add(i, kind, data, len);
+				}
+			}
+			_typed->Decode(output, _output_slot + TypedObjectBatch::FIRST_COLUMN, 0, selected);
+		}
+		output.SetCardinality(selected);
+		return;
+	}
+}
@@ -0,0 +1,369 @@
+#include "include/compressed_input.hpp"
+#include <zlib.h>
+#include <zstd.h>
+#include <cstring>
+#include <stdexcept>
+
+using duckdb::idx_t;
+
+static const char *const GZIP_SUFFIXES[] = {".gz", ".gzip"};
+static const char *const ZSTD_SUFFIXES[] = {".zst", ".zstd"};
+
+static bool HasSuffix(const std::string &path, const char *suffix) {
+	auto len = strlen(suffix);
+	if (path.size() <= len) {
+		return false;
+	}
+	for (size_t i = 0; i < len; i++) {
+		if (tolower(path[path.size() - len + i]) != suffix[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+RDFCompression CompressionFromPath(const std::string &path, std::string &stem) {
+	stem = path;
+	for (auto suffix : GZIP_SUFFIXES) {
+		if (HasSuffix(path, suffix)) {
+			stem = path.substr(0, path.size() - strlen(suffix));
+			return RDFCompression::GZIP;
+		}
+	}
+	for (auto suffix : ZSTD_SUFFIXES) {
+		if (HasSuffix(path, suffix)) {
+			stem = path.substr(0, path.size() - strlen(suffix));
+			return RDFCompression::ZSTD;
+		}
+	}
+	return RDFCompression::NONE;
+}
+
+bool IsPipeInput(duckdb::FileSystem &fs, const std::string &path) {
+	if (duckdb::FileSystem::IsRemoteFile(path)) {
+		return false;
+	}
+	try {
+		return fs.IsPipe(path);
+	} catch (std::exception &) {
+		return false;
+	}
+}
+
+RDFCompression DetectCompression(duckdb::FileSystem &fs, const std::string &path) {
+	std::string stem;
+	auto compression = CompressionFromPath(path, stem);
+	if (compression != RDFCompression::NONE) {
+		return compression;
+	}
+	// Bytes read from a pipe can't be read again, and opening a FIFO waits for its writer
+	if (IsPipeInput(fs, path)) {
+		return RDFCompression::NONE;
+	}
+	uint8_t magic[4] = {0, 0, 0, 0};
+	try {
+		auto handle = fs.OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ);
+		if (handle->Read(magic, sizeof(magic)) < (int64_t)sizeof(magic)) {
+			return RDFCompression::NONE;
+		}
+	} catch (std::exception &) {
+		// Reported when the file is opened for parsing
+		return RDFCompression::NONE;
+	}
+	if (magic[0] == 0x1f && magic[1] == 0x8b) {
+		return RDFCompression::GZIP;
+	}
+	if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+		return RDFCompression::ZSTD;
+	}
+	return RDFCompression::NONE;
+}
+
+duckdb::unique_ptr<duckdb::FileHandle> OpenRDFInput(duckdb::FileSystem &fs, const std::string &path,
+                                                    RDFCompression &compression) {
+	compression = DetectCompression(fs, path);
+	switch (compression) {
+	case RDFCompression::GZIP:
+		return fs.OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileCompressionType::GZIP);
+	default:
+		return fs.OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ);
+	}
+}
+
+// ------------------------------------------------------------
+// Frame boundaries
+// ------------------------------------------------------------
+
+static constexpr idx_t BGZF_HEADER_SIZE = 18;
+static constexpr idx_t BGZF_MAX_BLOCK_SIZE = 65536;
+
+// A gzip member header with the BC extra subfield (XLEN 6, as bgzip writes it) giving the block size
+static bool IsBGZFHeader(const uint8_t *p, idx_t &block_size) {
+	if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || !(p[3] & 4)) {
+		return false;
+	}
+	if (p[10] != 6 || p[11] != 0 || p[12] != 'B' || p[13] != 'C' || p[14] != 2 || p[15] != 0) {
+		return false;
+	}
+	block_size = (idx_t)(p[16] | (p[17] << 8)) + 1;
+	return true;
+}
+
+static std::vector<idx_t> FindBGZFBoundaries(duckdb::FileHandle &handle, idx_t file_size, idx_t range_size) {
+	std::vector<idx_t> boundaries;
+	uint8_t header[BGZF_HEADER_SIZE];
+	idx_t block_size;
+	if (file_size < BGZF_HEADER_SIZE) {
+		return boundaries;
+	}
+	handle.Read(header, BGZF_HEADER_SIZE, 0);
+	if (!IsBGZFHeader(header, block_size)) {
+		return boundaries;
+	}
+	boundaries.push_back(0);
+	// A window this large holds a whole block and the header of the block after it
+	std::vector<uint8_t> window(2 * BGZF_MAX_BLOCK_SIZE + 2 * BGZF_HEADER_SIZE);
+	for (idx_t target = range_size; target < file_size; target = boundaries.back() + range_size) {
+		idx_t window_size = duckdb::MinValue<idx_t>(window.size(), file_size - target);
+		handle.Read(window.data(), window_size, target);
+		idx_t found = duckdb::DConstants::INVALID_INDEX;
+		for (idx_t i = 0; i + BGZF_HEADER_SIZE <= window_size && i < BGZF_MAX_BLOCK_SIZE; i++) {
+			if (!IsBGZFHeader(window.data() + i, block_size)) {
+				continue;
+			}
+			// Compressed data can look like a header by chance; a real one is followed by another
+			idx_t next = i + block_size;
+			idx_t next_size;
+			if (target + next == file_size ||
+			    (next + BGZF_HEADER_SIZE <= window_size && IsBGZFHeader(window.data() + next, next_size))) {
+				found = target + i;
+				break;
+			}
+		}
+		if (found == duckdb::DConstants::INVALID_INDEX || found == file_size) {
+			break;
+		}
+		boundaries.push_back(found);
+	}
+	boundaries.push_back(file_size);
+	return boundaries;
+}
+
+static constexpr uint32_t ZSTD_SEEKABLE_MAGIC = 0x8F92EAB1;
+static constexpr idx_t ZSTD_SEEKABLE_FOOTER_SIZE = 9;
+
+static uint32_t LoadLE32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// The seek table of the zstd seekable format is a skippable frame at the end of the file
+static std::vector<idx_t> FindZstdBoundaries(duckdb::FileHandle &handle, idx_t file_size, idx_t range_size) {
+	std::vector<idx_t> boundaries;
+	uint8_t footer[ZSTD_SEEKABLE_FOOTER_SIZE];
+	if (file_size < ZSTD_SEEKABLE_FOOTER_SIZE + 8) {
+		return boundaries;
+	}
+	handle.Read(footer, ZSTD_SEEKABLE_FOOTER_SIZE, file_size - ZSTD_SEEKABLE_FOOTER_SIZE);
+	if (LoadLE32(footer + 5) != ZSTD_SEEKABLE_MAGIC) {
+		return boundaries;
+	}
+	idx_t frame_count = LoadLE32(footer);
+	idx_t entry_size = (footer[4] & 0x80) ? 12 : 8;
+	idx_t table_size = frame_count * entry_size;
+	if (table_size + ZSTD_SEEKABLE_FOOTER_SIZE + 8 > file_size) {
+		return boundaries;
+	}
+	std::vector<uint8_t> table(table_size);
+	handle.Read(table.data(), table_size, file_size - ZSTD_SEEKABLE_FOOTER_SIZE - table_size);
+	boundaries.push_back(0);
+	idx_t offset = 0;
+	for (idx_t frame = 0; frame < frame_count; frame++) {
+		if (offset - boundaries.back() >= range_size) {
+			boundaries.push_back(offset);
+		}
+		offset += LoadLE32(table.data() + frame * entry_size);
+	}
+	// The last range also holds the seek table, which the decoder skips
+	boundaries.push_back(file_size);
+	return boundaries;
+}
+
+std::vector<idx_t> FindFrameBoundaries(duckdb::FileHandle &handle, RDFCompression compression, idx_t file_size,
+                                       idx_t range_size) {
+	std::vector<idx_t> boundaries;
+	try {
+		if (compression == RDFCompression::GZIP) {
+			boundaries = FindBGZFBoundaries(handle, file_size, range_size);
+		} else if (compression == RDFCompression::ZSTD) {
+			boundaries = FindZstdBoundaries(handle, file_size, range_size);
+		}
+	} catch (std::exception &) {
+		boundaries.clear();
+	}
+	if (boundaries.size() <= 2) {
+		boundaries.clear();
+	}
+	return boundaries;
+}
+
+// ------------------------------------------------------------
+// FrameRangeReader
+// ------------------------------------------------------------
+
+static constexpr idx_t FRAME_INPUT_SIZE = 64 * 1024;
+static constexpr idx_t FRAME_OUTPUT_SIZE = 256 * 1024;
+
+FrameRangeReader::FrameRangeReader(duckdb::FileHandle &handle, RDFCompression compression, idx_t start, idx_t end)
+    : _handle(handle), _compression(compression), _end(end), _in(FRAME_INPUT_SIZE), _file_position(start),
+      _out(FRAME_OUTPUT_SIZE), _skipping(start > 0) {
+	if (_compression == RDFCompression::GZIP) {
+		auto stream = new z_stream();
+		// 16 + MAX_WBITS: read gzip headers; each BGZF block is a gzip member of its own
+		if (inflateInit2(stream, 16 + MAX_WBITS) != Z_OK) {
+			delete stream;
+			throw std::runtime_error("Unable to initialise gzip decompression");
+		}
+		_stream = stream;
+	} else {
+		auto stream = ZSTD_createDStream();
+		if (!stream || ZSTD_isError(ZSTD_initDStream(stream))) {
+			ZSTD_freeDStream(stream);
+			throw std::runtime_error("Unable to initialise zstd decompression");
+		}
+		_stream = stream;
+	}
+	// A whole file read from its start may be a pipe, which can't seek
+	if (start > 0) {
+		_handle.Seek(start);
+	}
+}
+
+FrameRangeReader::~FrameRangeReader() {
+	if (_compression == RDFCompression::GZIP) {
+		auto stream = static_cast<z_stream *>(_stream);
+		inflateEnd(stream);
+		delete stream;
+	} else {
+		ZSTD_freeDStream(static_cast<ZSTD_DStream *>(_stream));
+	}
+}
+
+bool FrameRangeReader::Decompress() {
+	_out_pos = 0;
+	_out_end = 0;
+	while (_out_end == 0) {
+		if (_in_pos == _in_end && !_input_done) {
+			int64_t read = _handle.Read(_in.data(), _in.size());
+			_in_pos = 0;
+			_in_end = read > 0 ? (idx_t)read : 0;
+			_file_position += _in_end;
+			_input_done = read <= 0;
+		}
+		if (_frame_start) {
+			_past_end = CompressedPosition() >= _end;
+			_frame_start = false;
+		}
+		// Every call stops at the end of a frame, so _out only ever holds bytes of one frame
+		if (_compression == RDFCompression::GZIP) {
+			auto stream = static_cast<z_stream *>(_stream);
+			stream->next_in = reinterpret_cast<Bytef *>(_in.data() + _in_pos);
+			stream->avail_in = (uInt)(_in_end - _in_pos);
+			stream->next_out = reinterpret_cast<Bytef *>(_out.data());
+			stream->avail_out = (uInt)_out.size();
+			int ret = inflate(stream, Z_NO_FLUSH);
+			_in_frame = _in_frame || _in_pos != _in_end - stream->avail_in;
+			_in_pos = _in_end - stream->avail_in;
+			_out_end = _out.size() - stream->avail_out;
+			if (ret == Z_STREAM_END) {
+				inflateReset(stream);
+				_frame_start = true;
+				_in_frame = false;
+			} else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+				throw std::runtime_error(std::string("Could not decompress gzip data: ") +
+				                         (stream->msg ? stream->msg : "invalid data"));
+			}
+		} else {
+			ZSTD_inBuffer input = {_in.data() + _in_pos, _in_end - _in_pos, 0};
+			ZSTD_outBuffer output = {_out.data(), _out.size(), 0};
+			size_t ret = ZSTD_decompressStream(static_cast<ZSTD_DStream *>(_stream), &output, &input);
+			if (ZSTD_isError(ret)) {
+				throw std::runtime_error(std::string("Could not decompress zstd data: ") + ZSTD_getErrorName(ret));
+			}
+			_in_frame = _in_frame || input.pos > 0;
+			_in_pos += input.pos;
+			_out_end = output.pos;
+			if (ret == 0) {
+				_frame_start = true;
+				_in_frame = false;
+			}
+		}
+		if (_out_end == 0 && _input_done && _in_pos == _in_end) {
+			if (_in_frame) {
+				// The file ends inside a gzip member or zstd frame
+				throw std::runtime_error("truncated compressed input");
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+idx_t FrameRangeReader::Read(char *buf, idx_t len) {
+	idx_t filled = 0;
+	while (filled < len && !_finished) {
+		if (_out_pos == _out_end && !Decompress()) {
+			_finished = true;
+			break;
+		}
+		auto data = _out.data() + _out_pos;
+		idx_t available = _out_end - _out_pos;
+		if (_skipping) {
+			// The line running into the range belongs to the range before
+			auto nl = static_cast<const char *>(memchr(data, '\n', available));
+			if (!nl) {
+				_out_pos = _out_end;
+				continue;
+			}
+			if (_past_end) {
+				// No line starts inside this range
+				_finished = true;
+				break;
+			}
+			_out_pos += (idx_t)(nl - data) + 1;
+			_skipping = false;
+			continue;
+		}
+		idx_t count = duckdb::MinValue<idx_t>(available, len - filled);
+		if (_past_end) {
+			// Past the range's frames, only the rest of the line that started inside them is read
+			auto nl = static_cast<const char *>(memchr(data, '\n', count));
+			if (nl) {
+				count = (idx_t)(nl - data) + 1;
+				_finished = true;
+			}
+		}
+		memcpy(buf + filled, data, count);
+		filled += count;
+		_out_pos += count;
+	}
+	return filled;
+}
+
+// ------------------------------------------------------------
+// RDFInputReader
+// ------------------------------------------------------------
+
+RDFInputReader::RDFInputReader(duckdb::FileHandle &handle, RDFCompression compression) : _handle(handle) {
+	if (compression == RDFCompression::ZSTD) {
+		_frames = std::unique_ptr<FrameRangeReader>(
+		    new FrameRangeReader(handle, compression, 0, duckdb::DConstants::INVALID_INDEX));
+	}
+}
+
+idx_t RDFInputReader::Read(char *buf, idx_t len) {
+	if (_frames) {
+		return _frames->Read(buf, len);
+	}
+	int64_t read = _handle.Read(buf, len);
+	return read > 0 ? (idx_t)read : 0;
+}
@@ -0,0 +1,216 @@
+#include "include/hdt_buffer.hpp"
+
+using namespace duckdb;
+
+// Blank nodes are returned without their _: prefix, as the other parsers return them
+static void NodeBytes(const std::string &term, const char *&data, idx_t &len) {
+	idx_t skip = term.size() >= 2 && term[0] == '_' && term[1] == ':' ? 2 : 0;
+	data = term.data() + skip;
+	len = term.size() - skip;
+}
+
+HDTBuffer::HDTBuffer(std::string path, std::string base_uri, FileSystem *fs, const bool strict_parsing,
+                     const bool expand_prefixes, const ITriplesBuffer::FileType file_type)
+    : ITriplesBuffer(path, base_uri, strict_parsing, expand_prefixes) {
+	if (!fs) {
+		throw std::runtime_error("HDTBuffer requires a valid DuckDB FileSystem pointer");
+	}
+	this->_fs = fs;
+}
+
+void HDTBuffer::StartParse() {
+	if (!_hdt) {
+		try {
+			_hdt = HDTFile::Open(*_fs, _file_path, _memory_map);
+		} catch (std::exception &ex) {
+			throw std::runtime_error("Could not read HDT file: " + _file_path + ": " + ex.what());
+		}
+	}
+	auto count = _hdt->TripleCount();
+	_begin = _range_end == DConstants::INVALID_INDEX ? 0 : MinValue<idx_t>(_range_start, count);
+	_end = _range_end == DConstants::INVALID_INDEX ? count : MinValue<idx_t>(_range_end, count);
+	_triple = _begin;
+}
+
+idx_t HDTBuffer::BytesRead() const {
+	if (!_hdt || _hdt->TripleCount() == 0) {
+		return 0;
+	}
+	return (idx_t)((double)_hdt->Size() * (double)(_triple - _begin) / (double)_hdt->TripleCount());
+}
+
+void HDTBuffer::Seek() {
+	_seeked = true;
+	std::string constant;
+	// With compact_iris the constant may be a CURIE, and the file holds the IRI it stands for
+	std::string expanded;
+	if (_filter && _filter->EqualityConstant(1, constant)) {
+		bool has_expanded = _compactor && _compactor->Expand(constant, expanded);
+		idx_t found[3] = {_hdt->LocateSubject(constant), _hdt->LocateSubject("_:" + constant),
+		                     has_expanded ? _hdt->LocateSubject(expanded) : 0};
+		idx_t subject = 0;
+		idx_t matches = 0;
+		for (auto id : found) {
+			if (id) {
+				subject = id;
+				matches++;
+			}
+		}
+		if (matches == 0) {
+			_triple = _end;
+			return;
+		}
+		// More than one term matches, say an IRI and a blank node label: all are scanned for
+		if (matches == 1) {
+			_triple = MaxValue<idx_t>(_triple, _hdt->FirstTriple(_hdt->FirstPair(subject)));
+			_end = MinValue<idx_t>(_end, _hdt->FirstTriple(_hdt->FirstPair(subject + 1)));
+		}
+	}
+	if (_filter && _filter->EqualityConstant(2, constant)) {
+		bool has_expanded = _compactor && _compactor->Expand(constant, expanded);
+		idx_t found[2] = {_hdt->LocatePredicate(constant), has_expanded ? _hdt->LocatePredicate(expanded) : 0};
+		if (!found[0] && !found[1]) {
+			_triple = _end;
+			return;
+		}
+		// Both match: pairs are not skipped by predicate
+		_predicate_filter = found[0] && found[1] ? 0 : MaxValue<idx_t>(found[0], found[1]);
+	}
+	if (_triple < _end) {
+		_pair = _hdt->PairOfTriple(_triple);
+		_subject = _hdt->SubjectOfPair(_pair);
+	}
+}
+
+void HDTBuffer::NextPair() {
+	if (_hdt->EndsSubject(_pair)) {
+		_subject++;
+	}
+	_pair++;
+}
+
+bool HDTBuffer::PassesFilter() {
+	if (_filter->HasFilter(0) && !_filter->Matches(0, nullptr, 0)) {
+		return false;
+	}
+	if ((_filter->HasFilter(1) && !_filter->Matches(1, _subject_data, _subject_len)) ||
+	    (_filter->HasFilter(2) && !_filter->Matches(2, _predicate_data, _predicate_len))) {
+		return false;
+	}
+	if ((_filter->HasFilter(3) && !_filter->Matches(3, _object_data, _object_len)) ||
+	    (_filter->HasFilter(4) && !_filter->Matches(4, _datatype_term, _datatype_term_len)) ||
+	    (_filter->HasFilter(5) && !_filter->Matches(5, _lang, _lang_len))) {
+		return false;
+	}
+	return true;
+}
+
+void HDTBuffer::WriteTriple() {
+	auto target = BeginRow();
+	// HDT has no graphs
+	WriteTerm(target, 0, nullptr, 0);
+	WriteTerm(target, 1, _subject_data, _subject_len);
+	WriteTerm(target, 2, _predicate_data, _predicate_len);
+	WriteTerm(target, 3, _object_data, _object_len);
+	WriteTerm(target, 4, _datatype_term, _datatype_term_len);
+	WriteTerm(target, 5, _lang, _lang_len);
+	if (target.typed && _datatype) {
+		WriteTypedObject(target, ClassifyDatatype(_datatype, _datatype_len), _object_data, _object_len);
+	}
+	EndRow(target);
+}
+
+void HDTBuffer::PopulateChunk(DataChunk &output) {
+	_current_chunk = &output;
+	_current_count = 0;
+	if (_filter) {
+		_filter->Refresh();
+	}
+	bool can_parse = TakeStagedRows(output);
+	if (!_seeked) {
+		Seek();
+	}
+	if (CountOnly() && _sample_fraction >= 1.0) {
+		// Nothing is decoded: the triples of the range are only counted
+		auto count = can_parse ? MinValue<idx_t>(_end - _triple, STANDARD_VECTOR_SIZE - _current_count) : 0;
+		_triple += count;
+		_current_count += count;
+		FinishChunk(output);
+		_current_chunk = nullptr;
+		return;
+	}
+	// Terms are only decoded for the columns that are returned or filtered on
+	bool typed = _typed != nullptr;
+	auto needed = [&](idx_t col) {
+		return _output_slot[col] >= 0 || (_filter && _filter->HasFilter(col));
+	};
+	bool need_subject = needed(1);
+	bool need_predicate = needed(2);
+	bool need_object = needed(3) || needed(4) || needed(5) || typed;
+	auto next_triple = [&]() {
+		bool ends_pair = _hdt->EndsPair(_triple);
+		_triple++;
+		if (ends_pair) {
+			NextPair();
+		}
+	};
+
+	while (can_parse && _current_count < STANDARD_VECTOR_SIZE && _triple < _end) {
+		auto predicate = _hdt->PredicateOfPair(_pair);
+		if (_predicate_filter && predicate != _predicate_filter) {
+			_triple = _hdt->FirstTriple(_pair + 1);
+			NextPair();
+			continue;
+		}
+		if (SkipSample()) {
+			next_triple();
+			continue;
+		}
+		if (need_subject && _subject != _subject_id) {
+			_hdt->Subject(_subject, _subject_term);
+			_subject_id = _subject;
+			NodeBytes(_subject_term, _subject_data, _subject_len);
+			if (_subject_data == _subject_term.data()) {
+				_subject_data = CompactIRI(1, _subject_data, _subject_len);
+			}
+		}
+		if (need_predicate && predicate != _predicate_id) {
+			_hdt->Predicate(predicate, _predicate_term);
+			_predicate_id = predicate;
+			_predicate_len = _predicate_term.size();
+			_predicate_data = CompactIRI(2, _predicate_term.data(), _predicate_len);
+		}
+		if (need_object) {
+			_hdt->Object(_hdt->ObjectOfTriple(_triple), _object_term);
+			// Literals are stored as "lexical form", followed by @language or ^^<datatype>
+			auto close = _object_term.rfind('"');
+			_datatype = _lang = nullptr;
+			_datatype_len = _lang_len = 0;
+			if (!_object_term.empty() && _object_term[0] == '"' && close > 0 && close != std::string::npos) {
+				_object_data = _object_term.data() + 1;
+				_object_len = close - 1;
+				auto suffix = close + 1;
+				if (suffix < _object_term.size() && _object_term[suffix] == '@') {
+					_lang = _object_term.data() + suffix + 1;
+					_lang_len = _object_term.size() - suffix - 1;
+				} else if (_object_term.compare(suffix, 3, "^^<") == 0 && _object_term.back() == '>') {
+					_datatype = _object_term.data() + suffix + 3;
+					_datatype_len = _object_term.size() - suffix - 4;
+				}
+			} else {
+				NodeBytes(_object_term, _object_data, _object_len);
+				if (_object_data == _object_term.data()) {
+					_object_data = CompactIRI(3, _object_data, _object_len);
+				}
+			}
+			_datatype_term_len = _datatype_len;
+			_datatype_term = CompactIRI(4, _datatype, _datatype_term_len);
+		}
+		if (!_filter || PassesFilter()) {
+			WriteTriple();
+		}
+		next_triple();
+	}
+	FinishChunk(output);
+	_current_chunk = nullptr;
+}
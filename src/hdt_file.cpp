@@ -0,0 +1,457 @@
+#include "include/hdt_file.hpp"
+#include "include/compressed_input.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace duckdb;
+
+// Control information types
+static constexpr uint8_t HDT_GLOBAL = 1;
+static constexpr uint8_t HDT_HEADER = 2;
+static constexpr uint8_t HDT_DICTIONARY = 3;
+static constexpr uint8_t HDT_TRIPLES = 4;
+// Types of the structures in the sections
+static constexpr uint8_t HDT_SEQUENCE_LOG = 1;
+static constexpr uint8_t HDT_BITMAP_PLAIN = 1;
+static constexpr uint8_t HDT_SECTION_PFC = 2;
+
+static const char HDT_DICTIONARY_FOUR[] = "<http://purl.org/HDT/hdt#dictionaryFour>";
+static const char HDT_TRIPLES_BITMAP[] = "<http://purl.org/HDT/hdt#triplesBitmap>";
+// Triple component order of bitmap triples
+static const char HDT_ORDER_SPO[] = "1";
+
+static void Need(const char *pos, const char *end, idx_t len) {
+	if (pos > end || (idx_t)(end - pos) < len) {
+		throw std::runtime_error("Truncated HDT file");
+	}
+}
+
+// Variable length integer: 7 bits per byte, least significant first, the last byte flagged by its high bit
+static const char *ReadVByte(const char *pos, const char *end, uint64_t &value) {
+	value = 0;
+	for (idx_t shift = 0; shift < 64; shift += 7) {
+		Need(pos, end, 1);
+		auto byte = (uint8_t)*pos++;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (byte & 0x80) {
+			return pos;
+		}
+	}
+	throw std::runtime_error("Invalid number in HDT file");
+}
+
+static const char *ReadString(const char *pos, const char *end, std::string &out) {
+	auto terminator = (const char *)memchr(pos, '\0', (size_t)(end - pos));
+	if (!terminator) {
+		throw std::runtime_error("Truncated HDT file");
+	}
+	out.assign(pos, (size_t)(terminator - pos));
+	return terminator + 1;
+}
+
+// "$HDT", the type, the format, "key=value;" properties and a CRC16
+struct HDTControl {
+	std::string format;
+	std::string properties;
+
+	std::string Property(const std::string &key) const {
+		idx_t start = 0;
+		while (start < properties.size()) {
+			auto stop = properties.find(';', start);
+			if (stop == std::string::npos) {
+				stop = properties.size();
+			}
+			auto entry = properties.substr(start, stop - start);
+			auto eq = entry.find('=');
+			if (eq != std::string::npos && entry.compare(0, eq, key) == 0) {
+				return entry.substr(eq + 1);
+			}
+			start = stop + 1;
+		}
+		return std::string();
+	}
+};
+
+static const char *ReadControl(const char *pos, const char *end, uint8_t type, HDTControl &control) {
+	Need(pos, end, 5);
+	if (memcmp(pos, "$HDT", 4) != 0) {
+		throw std::runtime_error("Not an HDT file");
+	}
+	if ((uint8_t)pos[4] != type) {
+		throw std::runtime_error("Unexpected section in HDT file");
+	}
+	pos = ReadString(pos + 5, end, control.format);
+	pos = ReadString(pos, end, control.properties);
+	Need(pos, end, 2);
+	return pos + 2;
+}
+
+static idx_t PopCount(uint64_t x) {
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (idx_t)((x * 0x0101010101010101ULL) >> 56);
+}
+
+const char *HDTLogArray::Load(const char *pos, const char *end) {
+	Need(pos, end, 2);
+	if ((uint8_t)pos[0] != HDT_SEQUENCE_LOG) {
+		throw std::runtime_error("Unsupported sequence type in HDT file");
+	}
+	_bits = (uint8_t)pos[1];
+	if (_bits > 64) {
+		throw std::runtime_error("Invalid sequence in HDT file");
+	}
+	uint64_t count;
+	pos = ReadVByte(pos + 2, end, count);
+	// CRC8 of the preamble
+	Need(pos, end, 1);
+	pos++;
+	_count = count;
+	idx_t bytes = (idx_t)((count * _bits + 7) / 8);
+	Need(pos, end, bytes + 4);
+	_data = (const uint8_t *)pos;
+	// The data, then its CRC32
+	return pos + bytes + 4;
+}
+
+uint64_t HDTLogArray::Get(idx_t i) const {
+	if (_bits == 0) {
+		return 0;
+	}
+	idx_t bit = i * _bits;
+	auto data = _data + (bit >> 3);
+	idx_t shift = bit & 7;
+	// An entry spans up to 9 bytes
+	idx_t bytes = (shift + _bits + 7) / 8;
+	uint64_t value = 0;
+	for (idx_t b = 0; b < bytes && b < 8; b++) {
+		value |= (uint64_t)data[b] << (8 * b);
+	}
+	value >>= shift;
+	if (bytes > 8) {
+		value |= (uint64_t)data[8] << (64 - shift);
+	}
+	return _bits == 64 ? value : value & ((1ULL << _bits) - 1);
+}
+
+const char *HDTBitmap::Load(const char *pos, const char *end) {
+	Need(pos, end, 1);
+	if ((uint8_t)pos[0] != HDT_BITMAP_PLAIN) {
+		throw std::runtime_error("Unsupported bitmap type in HDT file");
+	}
+	uint64_t size;
+	pos = ReadVByte(pos + 1, end, size);
+	Need(pos, end, 1);
+	pos++;
+	_size = size;
+	idx_t bytes = (_size + 7) / 8;
+	Need(pos, end, bytes + 4);
+	_data = (const uint8_t *)pos;
+	return pos + bytes + 4;
+}
+
+uint64_t HDTBitmap::Word(idx_t w) const {
+	idx_t first = w * 8;
+	idx_t bytes = MinValue<idx_t>(8, (_size + 7) / 8 - first);
+	uint64_t word = 0;
+	for (idx_t b = 0; b < bytes; b++) {
+		word |= (uint64_t)_data[first + b] << (8 * b);
+	}
+	// Padding bits of the last byte are not part of the bitmap
+	idx_t valid = _size - w * 64;
+	return valid >= 64 ? word : word & ((1ULL << valid) - 1);
+}
+
+void HDTBitmap::BuildDirectory() const {
+	std::call_once(_directory_once, [this]() {
+		idx_t words = (_size + 63) / 64;
+		idx_t ones = 0;
+		for (idx_t w = 0; w < words; w++) {
+			if (w % (BLOCK_BITS / 64) == 0) {
+				_directory.push_back(ones);
+			}
+			ones += PopCount(Word(w));
+		}
+		_directory.push_back(ones);
+	});
+}
+
+idx_t HDTBitmap::Ones() const {
+	BuildDirectory();
+	return _directory.back();
+}
+
+idx_t HDTBitmap::Rank(idx_t pos) const {
+	BuildDirectory();
+	pos = MinValue<idx_t>(pos, _size);
+	idx_t block = pos / BLOCK_BITS;
+	if (block >= _directory.size() - 1) {
+		return _directory.back();
+	}
+	idx_t rank = _directory[block];
+	for (idx_t w = block * (BLOCK_BITS / 64); w < pos / 64; w++) {
+		rank += PopCount(Word(w));
+	}
+	if (pos % 64) {
+		rank += PopCount(Word(pos / 64) & ((1ULL << (pos % 64)) - 1));
+	}
+	return rank;
+}
+
+idx_t HDTBitmap::Select(idx_t k) const {
+	BuildDirectory();
+	if (k == 0 || k > _directory.back()) {
+		return _size;
+	}
+	// Last block with fewer than k set bits before it
+	idx_t lo = 0;
+	idx_t hi = _directory.size() - 2;
+	while (lo < hi) {
+		idx_t mid = (lo + hi + 1) / 2;
+		if (_directory[mid] < k) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	idx_t remaining = k - _directory[lo];
+	for (idx_t w = lo * (BLOCK_BITS / 64);; w++) {
+		auto word = Word(w);
+		auto count = PopCount(word);
+		if (count < remaining) {
+			remaining -= count;
+			continue;
+		}
+		for (idx_t bit = 0;; bit++) {
+			if ((word >> bit) & 1) {
+				if (--remaining == 0) {
+					return w * 64 + bit;
+				}
+			}
+		}
+	}
+}
+
+const char *HDTDictionarySection::Load(const char *pos, const char *end) {
+	Need(pos, end, 1);
+	if ((uint8_t)pos[0] != HDT_SECTION_PFC) {
+		throw std::runtime_error("Unsupported dictionary section type in HDT file");
+	}
+	uint64_t count, bytes, block_size;
+	pos = ReadVByte(pos + 1, end, count);
+	pos = ReadVByte(pos, end, bytes);
+	pos = ReadVByte(pos, end, block_size);
+	Need(pos, end, 1);
+	pos = _blocks.Load(pos + 1, end);
+	_count = count;
+	_block_size = block_size;
+	if (_count > 0 && (_block_size == 0 || _blocks.Count() < (_count + _block_size - 1) / _block_size)) {
+		throw std::runtime_error("Invalid dictionary section in HDT file");
+	}
+	Need(pos, end, bytes + 4);
+	_data = pos;
+	_data_end = pos + bytes;
+	return _data_end + 4;
+}
+
+void HDTDictionarySection::Extract(idx_t id, std::string &out) const {
+	if (id == 0 || id > _count) {
+		throw std::runtime_error("Invalid term id in HDT file");
+	}
+	auto pos = BlockStart((id - 1) / _block_size);
+	pos = ReadString(pos, _data_end, out);
+	// The other strings of a block are the length of the prefix they share with the one before,
+	// then the rest
+	for (idx_t i = (id - 1) % _block_size; i > 0; i--) {
+		uint64_t shared;
+		pos = ReadVByte(pos, _data_end, shared);
+		auto terminator = (const char *)memchr(pos, '\0', (size_t)(_data_end - pos));
+		if (!terminator || shared > out.size()) {
+			throw std::runtime_error("Invalid dictionary section in HDT file");
+		}
+		out.resize(shared);
+		out.append(pos, (size_t)(terminator - pos));
+		pos = terminator + 1;
+	}
+}
+
+// Bytewise order, the order of the dictionary sections
+static int CompareTerm(const std::string &a, const char *b, idx_t b_len) {
+	idx_t n = MinValue<idx_t>(a.size(), b_len);
+	int cmp = n > 0 ? memcmp(a.data(), b, n) : 0;
+	if (cmp != 0) {
+		return cmp;
+	}
+	return a.size() < b_len ? -1 : (a.size() > b_len ? 1 : 0);
+}
+
+idx_t HDTDictionarySection::Locate(const char *term, idx_t len) const {
+	if (_count == 0) {
+		return 0;
+	}
+	// The last block whose first term is not after the term
+	idx_t lo = 0;
+	idx_t hi = (_count - 1) / _block_size;
+	std::string current;
+	while (lo < hi) {
+		idx_t mid = (lo + hi + 1) / 2;
+		ReadString(BlockStart(mid), _data_end, current);
+		if (CompareTerm(current, term, len) <= 0) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	idx_t first = lo * _block_size + 1;
+	idx_t last = MinValue<idx_t>(first + _block_size - 1, _count);
+	for (idx_t id = first; id <= last; id++) {
+		Extract(id, current);
+		int cmp = CompareTerm(current, term, len);
+		if (cmp == 0) {
+			return id;
+		}
+		if (cmp > 0) {
+			break;
+		}
+	}
+	return 0;
+}
+
+std::shared_ptr<HDTFile> HDTFile::Open(FileSystem &fs, const std::string &path, bool memory_map) {
+	auto file = std::shared_ptr<HDTFile>(new HDTFile());
+	auto compression = DetectCompression(fs, path);
+	if (memory_map && compression == RDFCompression::NONE) {
+		file->_mapping = MappedFile::Map(path);
+	}
+	if (file->_mapping) {
+		file->Load(file->_mapping->Data(), file->_mapping->Size());
+		return file;
+	}
+	// Not mapped: the sections are read in place, so the whole file is read first
+	auto handle = OpenRDFInput(fs, path, compression);
+	RDFInputReader reader(*handle, compression);
+	const idx_t read_size = 1024 * 1024;
+	idx_t size = 0;
+	while (true) {
+		file->_contents.resize(size + read_size);
+		idx_t read = reader.Read(&file->_contents[size], read_size);
+		if (read == 0) {
+			break;
+		}
+		size += read;
+	}
+	file->_contents.resize(size);
+	file->Load(file->_contents.data(), size);
+	return file;
+}
+
+idx_t HDTFile::ReadTripleCount(FileSystem &fs, const std::string &path) {
+	// The header follows the global control information, both short
+	static constexpr idx_t HEADER_WINDOW = 64 * 1024;
+	static const char VOID_TRIPLES[] = "<http://rdfs.org/ns/void#triples>";
+	RDFCompression compression;
+	auto handle = OpenRDFInput(fs, path, compression);
+	RDFInputReader reader(*handle, compression);
+	std::string buf(HEADER_WINDOW, '\0');
+	idx_t size = 0;
+	while (size < buf.size()) {
+		idx_t read = reader.Read(&buf[size], buf.size() - size);
+		if (read == 0) {
+			break;
+		}
+		size += read;
+	}
+	auto pos = buf.data();
+	auto end = buf.data() + size;
+	HDTControl control;
+	pos = ReadControl(pos, end, HDT_GLOBAL, control);
+	pos = ReadControl(pos, end, HDT_HEADER, control);
+	auto header_length = (idx_t)std::strtoull(control.Property("length").c_str(), nullptr, 10);
+	std::string header(pos, MinValue<idx_t>(header_length, (idx_t)(end - pos)));
+	auto found = header.find(VOID_TRIPLES);
+	if (found == std::string::npos) {
+		return 0;
+	}
+	auto quote = header.find('"', found + sizeof(VOID_TRIPLES) - 1);
+	if (quote == std::string::npos) {
+		return 0;
+	}
+	return (idx_t)std::strtoull(header.c_str() + quote + 1, nullptr, 10);
+}
+
+void HDTFile::Load(const char *data, idx_t size) {
+	_size = size;
+	auto pos = data;
+	auto end = data + size;
+	HDTControl control;
+	pos = ReadControl(pos, end, HDT_GLOBAL, control);
+
+	// The header is RDF describing the dataset, not part of it
+	pos = ReadControl(pos, end, HDT_HEADER, control);
+	auto header_length = (idx_t)std::strtoull(control.Property("length").c_str(), nullptr, 10);
+	Need(pos, end, header_length);
+	pos += header_length;
+
+	pos = ReadControl(pos, end, HDT_DICTIONARY, control);
+	if (control.format != HDT_DICTIONARY_FOUR) {
+		throw std::runtime_error("Unsupported HDT dictionary " + control.format);
+	}
+	auto mapping = control.Property("mapping");
+	if (!mapping.empty() && mapping != "2") {
+		throw std::runtime_error("Unsupported HDT dictionary mapping " + mapping);
+	}
+	pos = _shared.Load(pos, end);
+	pos = _subjects.Load(pos, end);
+	pos = _predicate_terms.Load(pos, end);
+	pos = _objects_only.Load(pos, end);
+
+	pos = ReadControl(pos, end, HDT_TRIPLES, control);
+	if (control.format != HDT_TRIPLES_BITMAP) {
+		throw std::runtime_error("Unsupported HDT triples " + control.format);
+	}
+	auto order = control.Property("order");
+	if (!order.empty() && order != HDT_ORDER_SPO) {
+		throw std::runtime_error("Unsupported HDT triple order " + order);
+	}
+	pos = _subject_ends.Load(pos, end);
+	pos = _pair_ends.Load(pos, end);
+	pos = _predicates.Load(pos, end);
+	pos = _objects.Load(pos, end);
+	if (_subject_ends.Size() != _predicates.Count() || _pair_ends.Size() != _objects.Count()) {
+		throw std::runtime_error("Invalid bitmap triples in HDT file");
+	}
+}
+
+void HDTFile::Subject(idx_t id, std::string &out) const {
+	if (id <= _shared.Count()) {
+		_shared.Extract(id, out);
+	} else {
+		_subjects.Extract(id - _shared.Count(), out);
+	}
+}
+
+void HDTFile::Predicate(idx_t id, std::string &out) const {
+	_predicate_terms.Extract(id, out);
+}
+
+void HDTFile::Object(idx_t id, std::string &out) const {
+	if (id <= _shared.Count()) {
+		_shared.Extract(id, out);
+	} else {
+		_objects_only.Extract(id - _shared.Count(), out);
+	}
+}
+
+idx_t HDTFile::LocateSubject(const std::string &term) const {
+	auto id = _shared.Locate(term.data(), term.size());
+	if (id) {
+		return id;
+	}
+	id = _subjects.Locate(term.data(), term.size());
+	return id ? id + _shared.Count() : 0;
+}
+
+idx_t HDTFile::LocatePredicate(const std::string &term) const {
+	return _predicate_terms.Locate(term.data(), term.size());
+}
@@ -3,25 +3,24 @@
 #define I_TRIPLES_BUFFER_H
 #include "duckdb.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "rdf_filter.hpp"
+#include "term_dictionary.hpp"
+#include "typed_objects.hpp"
+#include "compressed_input.hpp"
+#include "read_ahead.hpp"
+#include "mapped_file.hpp"
+#include "iri_compactor.hpp"
 #include <algorithm>
-#include <queue>
-
-/*
-    Holder for a single row of RDF
-*/
-struct RDFRow {
-	std::string graph;
-	std::string subject;
-	std::string predicate;
-	std::string object;
-	std::string datatype;
-	std::string lang;
-};
+#include <memory>
+
+struct LineRangeClaim;
 
 class ITriplesBuffer {
 public:
 	// Supported file type hints for parsing
-	enum FileType { TURTLE = 0, NQUADS, NTRIPLES, TRIG, XML, UNKNOWN };
+	enum FileType { TURTLE = 0, NQUADS, NTRIPLES, TRIG, XML, HDT, UNKNOWN };
 
 	ITriplesBuffer(std::string path, std::string base_uri, bool strict_parsing = true,
 	               const bool expand_prefixes = false)
@@ -31,31 +30,211 @@ public:
 	virtual void StartParse() = 0;
 	virtual ~ITriplesBuffer() = default;
 
+	// Bytes of the input the parser has taken so far, for progress reporting
+	virtual duckdb::idx_t BytesRead() const {
+		return _read_ahead ? _read_ahead->BytesRead() : 0;
+	}
+
+	// The six term columns, then the typed object columns (see TypedObjectBatch)
+	static constexpr duckdb::idx_t COLUMN_COUNT = TypedObjectBatch::FIRST_COLUMN + TypedObjectBatch::COLUMN_COUNT;
+
 	// Maps original column indices → output DataChunk slot (-1 = skip).
-	// Default {0,1,2,3,4,5} is the identity (all 6 columns present).
-	int8_t _output_slot[6] = {0, 1, 2, 3, 4, 5};
+	// Default {0,1,2,3,4,5} is the identity (all 6 term columns present).
+	int8_t _output_slot[COLUMN_COUNT] = {0, 1, 2, 3, 4, 5, -1, -1, -1, -1, -1};
 
 	void SetColumnIds(const duckdb::vector<duckdb::column_t> &col_ids) {
-		std::fill(_output_slot, _output_slot + 6, (int8_t)-1);
+		std::fill(_output_slot, _output_slot + COLUMN_COUNT, (int8_t)-1);
+		_returns_columns = false;
 		for (duckdb::idx_t i = 0; i < col_ids.size(); i++) {
-			if (col_ids[i] < 6)
+			if (col_ids[i] < COLUMN_COUNT) {
 				_output_slot[col_ids[i]] = (int8_t)i;
+				_returns_columns = true;
+			}
+		}
+		for (duckdb::idx_t col = 0; col < 6; col++) {
+			if (_output_slot[col] >= 0 && IsDictionaryColumn(col) && !_dictionaries[col]) {
+				_dictionaries[col].reset(new TermDictionary());
+			}
+		}
+		for (duckdb::idx_t col = TypedObjectBatch::FIRST_COLUMN; col < COLUMN_COUNT; col++) {
+			if (_output_slot[col] >= 0 && !_typed) {
+				_typed.reset(new TypedObjectBatch());
+			}
+		}
+	}
+
+	// graph, predicate, object_datatype and object_lang rarely have more than a few distinct values
+	static bool IsDictionaryColumn(duckdb::idx_t col) {
+		return col == 0 || col == 2 || col == 4 || col == 5;
+	}
+
+	// Restrict parsing to the lines owned by the byte range [start, end) (see LineRangeReader).
+	// Only honoured by buffers for line-oriented formats; must be called before StartParse.
+	void SetByteRange(duckdb::idx_t start, duckdb::idx_t end) {
+		_range_start = start;
+		_range_end = end;
+	}
+
+	// Shares the progress of the byte range with the scheduler, which may split off its tail
+	void SetRangeClaim(std::shared_ptr<LineRangeClaim> claim) {
+		_range_claim = std::move(claim);
+	}
+
+	// Size of the blocks read ahead of the parser; must be called before StartParse
+	void SetBufferSize(duckdb::idx_t buffer_size) {
+		_buffer_size = buffer_size;
+	}
+
+	// Lets the NTriples/NQuads fast path map local files into memory; must be called before StartParse
+	void SetMemoryMap(bool memory_map) {
+		_memory_map = memory_map;
+	}
+
+	// Starts reading the input in the background, for a buffer that will be parsed next.
+	// Must be called after StartParse.
+	virtual void Prefetch() {
+		if (_read_ahead) {
+			_read_ahead->Prefetch();
 		}
 	}
 
+	// Statements failing the pushed-down filters are dropped inside the parser callbacks
+	void SetFilter(duckdb::unique_ptr<RDFStatementFilter> filter) {
+		_filter = std::move(filter);
+	}
+
+	// Charges the rows the buffer holds to DuckDB's memory limit, and lets the buffer manager spill
+	// staged rows to disk; must be called before StartParse
+	void SetBufferManager(duckdb::BufferManager &buffer_manager) {
+		_buffer_manager = &buffer_manager;
+	}
+
+	// Keeps each statement with probability fraction, decided before it is filtered or written; must be
+	// called before StartParse
+	void SetSample(double fraction, uint64_t seed) {
+		_sample_fraction = fraction;
+		_sample_state = seed;
+	}
+
+	// Rewrites IRIs as CURIEs with the prefixes of compactor and those the file declares; must be
+	// called before StartParse
+	void SetCompactor(std::unique_ptr<IRICompactor> compactor) {
+		_compactor = std::move(compactor);
+	}
+
 protected:
+	// Where a row is written: the output chunk while it has room, then a staging chunk of the same layout
+	struct RowTarget {
+		duckdb::DataChunk *chunk;
+		duckdb::idx_t row;
+		bool staged;
+		// Set when typed object columns are projected
+		TypedObjectBatch *typed;
+	};
+	RowTarget BeginRow();
+	void EndRow(const RowTarget &target);
+	// Writes the term of a column, data == nullptr for NULL
+	void WriteTerm(const RowTarget &target, duckdb::idx_t col, const char *data, duckdb::idx_t len);
+	// No column is returned or filtered on, as for COUNT(*): statements are counted, not written
+	bool CountOnly() const {
+		return !_returns_columns && !_filter;
+	}
+	void CountRow() {
+		EndRow(BeginRow());
+	}
+	// True for a statement left out of the sample (splitmix64, so each buffer's draws are reproducible)
+	bool SkipSample() {
+		if (_sample_fraction >= 1.0) {
+			return false;
+		}
+		uint64_t z = (_sample_state += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z ^= z >> 31;
+		return (double)(z >> 11) / 9007199254740992.0 >= _sample_fraction;
+	}
+	// Records a literal object of one of the datatypes decoded into the typed object columns
+	void WriteTypedObject(const RowTarget &target, RDFObjectKind kind, const char *data, duckdb::idx_t len) {
+		if (target.typed && kind != RDFObjectKind::NONE) {
+			target.typed->Add(target.row, kind, data, len);
+		}
+	}
+	// Starts every PopulateChunk: moves the oldest staging chunk into the empty output chunk.
+	// Returns false if later staging chunks remain, in which case nothing may be parsed into output.
+	bool TakeStagedRows(duckdb::DataChunk &output);
+	// Allocator of the chunks the buffer fills itself: the buffer manager's when one is set
+	duckdb::Allocator &ChunkAllocator() const {
+		return _buffer_manager ? _buffer_manager->GetBufferAllocator() : duckdb::Allocator::DefaultAllocator();
+	}
+	// Emits the dictionary columns of the chunk and sets its size; ends every PopulateChunk
+	void FinishChunk(duckdb::DataChunk &output);
+	// The bytes an IRI of a column is filtered on and written as: its CURIE if a prefix matches,
+	// else the IRI itself. The CURIE stays valid until the next IRI of the column.
+	const char *CompactIRI(duckdb::idx_t col, const char *data, duckdb::idx_t &len);
+	// A prefix declared by the file, for compact_iris
+	void AddFilePrefix(const std::string &name, const std::string &ns);
+
 	// Use DuckDB FileSystem and FileHandle for reading files (allows remote filesystems)
 	duckdb::FileSystem *_fs = nullptr;
 	std::unique_ptr<duckdb::FileHandle> _file_handle;
+	// Set when the file is compressed
+	RDFCompression _compression = RDFCompression::NONE;
+	// Reads _file_handle front to back, decompressing zstd input
+	std::unique_ptr<RDFInputReader> _input_reader;
 	std::string _base_uri;
 	std::string _file_path;
+	// The parser reads its input through this, set up by StartParse. Reads on its own thread, so
+	// subclasses reset it before the sources it reads from are destroyed.
+	std::unique_ptr<ReadAheadBuffer> _read_ahead;
+	duckdb::idx_t _buffer_size = ReadAheadBuffer::DEFAULT_BUFFER_SIZE;
+	bool _memory_map = false;
+	// Set when the input is a mapped file: terms pointing into it are written without being copied
+	duckdb::buffer_ptr<MappedFile> _mapping;
+	// Per column, the vector last given a reference to _mapping in this PopulateChunk call
+	duckdb::Vector *_mapped_vector[6] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
 
 	duckdb::DataChunk *_current_chunk = nullptr;
 	duckdb::idx_t _current_count = 0;
-	std::deque<RDFRow> _overflow_buffer;
+	// Some term or typed object column is returned
+	bool _returns_columns = true;
+	// Set with SetSample; _sample_state is the generator state
+	double _sample_fraction = 1.0;
+	uint64_t _sample_state = 0;
+	// Rows parsed after the output chunk filled up, returned by the following PopulateChunk calls: first
+	// those of _staged_rows, then those of _staging. A single parser step can stage any number of rows,
+	// so each full staging chunk is moved to _staged_rows, which the buffer manager may spill to disk.
+	struct StagedChunk {
+		duckdb::unique_ptr<duckdb::DataChunk> chunk;
+		duckdb::unique_ptr<TypedObjectBatch> typed;
+	};
+	StagedChunk _staging;
+	duckdb::unique_ptr<duckdb::ColumnDataCollection> _staged_rows;
+	duckdb::ColumnDataScanState _staged_scan;
+	duckdb::idx_t _staged_taken = 0;
+	void SpillStaging();
+	duckdb::BufferManager *_buffer_manager = nullptr;
 	bool _eof = false;
 	bool _strict_parsing = true;
 	bool _expand_prefixes = false;
+	// Byte range to parse; _range_end == INVALID_INDEX means the whole file
+	duckdb::idx_t _range_start = 0;
+	duckdb::idx_t _range_end = duckdb::DConstants::INVALID_INDEX;
+	std::shared_ptr<LineRangeClaim> _range_claim;
+	duckdb::unique_ptr<RDFStatementFilter> _filter;
+	std::unique_ptr<TermDictionary> _dictionaries[6];
+	// Set with compact_iris. Per column, the last IRI compacted and its CURIE: runs of one subject
+	// or predicate are looked up once.
+	std::unique_ptr<IRICompactor> _compactor;
+	struct CompactedIRI {
+		bool valid = false;
+		bool compacted = false;
+		std::string iri;
+		std::string curie;
+	};
+	CompactedIRI _compacted[6];
+	// Typed objects of the output chunk, and the number of its rows that came decoded from staging
+	std::unique_ptr<TypedObjectBatch> _typed;
+	duckdb::idx_t _decoded_rows = 0;
 };
 
 #endif // I_TRIPLES_BUFFER_H
@@ -0,0 +1,62 @@
+#ifndef CACHE_BUFFER_H
+#define CACHE_BUFFER_H
+
+#include "I_triples_buffer.hpp"
+#include "parse_cache.hpp"
+
+/*
+    Buffer over the parse cache (see parse_cache.hpp), in one of two modes:
+
+    - reading: returns the statements of a run of row groups of a cache file. Only the projected
+      and filtered columns are read, filters are evaluated once per distinct term of a group, and
+      the term columns are returned as dictionary vectors over the group's terms.
+    - building: parses the whole file with the buffer it wraps, writing every statement to a new
+      cache file, and applies the scan's projection and filters to what it returns. The cache is
+      only published once the file has been parsed to its end.
+*/
+class CacheBuffer : public ITriplesBuffer {
+public:
+	// Reads row groups [group_start, group_end) of a cache file that matches key
+	CacheBuffer(duckdb::FileSystem &fs, const std::string &cache_path, const ParseCacheKey &key,
+	            duckdb::idx_t group_start, duckdb::idx_t group_end);
+	// Parses with inner, set up for the whole file, and caches what it parses
+	CacheBuffer(std::unique_ptr<ITriplesBuffer> inner, duckdb::FileSystem &fs, const std::string &cache_path,
+	            const ParseCacheKey &key);
+
+	void PopulateChunk(duckdb::DataChunk &output) override;
+	void StartParse() override;
+	void Prefetch() override;
+	duckdb::idx_t BytesRead() const override;
+
+private:
+	void PopulateFromCache(duckdb::DataChunk &output);
+	void PopulateFromParse(duckdb::DataChunk &output);
+	// Loads the next row group; false once the last one has been returned
+	bool NextGroup();
+	// Whether the row at index idx of a column passes its filter, memoized per term
+	bool TermMatches(duckdb::idx_t col, uint32_t idx);
+	void CacheChunk(duckdb::DataChunk &chunk);
+	// Drops the cache being built after a write error; the scan itself goes on
+	void AbandonCache();
+
+	// Reading
+	duckdb::unique_ptr<ParseCacheFile> _cache;
+	duckdb::idx_t _group_next = 0;
+	duckdb::idx_t _group_end = 0;
+	duckdb::unique_ptr<CacheRowGroup> _group;
+	duckdb::idx_t _group_row = 0;
+	duckdb::idx_t _cache_bytes_read = 0;
+	// Per column and term: the generation the filter result was computed in, shifted left, and the result
+	std::vector<uint32_t> _memo[CacheRowGroup::COLUMN_COUNT];
+	uint32_t _generation = 0;
+	// Kind of each object_datatype term of the group, for the typed object columns
+	std::vector<RDFObjectKind> _kinds;
+
+	// Building
+	std::unique_ptr<ITriplesBuffer> _inner;
+	duckdb::DataChunk _parsed;
+	CacheRowGroupBuilder _builder;
+	duckdb::unique_ptr<ParseCacheWriter> _writer;
+};
+
+#endif // CACHE_BUFFER_H
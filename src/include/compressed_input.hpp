@@ -0,0 +1,102 @@
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "line_range_reader.hpp"
+#include <string>
+#include <vector>
+
+/*
+    Compressed input. gzip and zstd files are recognised by their suffix (.gz, .gzip, .zst, .zstd)
+    or, failing that, by their magic bytes, and are decompressed while they are read through
+    DuckDB's compressed file handles.
+
+    Files made of independently compressed frames can also be split between threads: BGZF (the
+    blocked gzip written by bgzip) and the zstd seekable format. A range of such a file is a run
+    of whole frames, decompressed by FrameRangeReader, which hands out the lines of the range by
+    the same rule as LineRangeReader, applied to the decompressed bytes of its frames.
+*/
+
+enum class RDFCompression : uint8_t { NONE, GZIP, ZSTD };
+
+// Compression named by the suffix of a path; stem is set to the path without that suffix
+RDFCompression CompressionFromPath(const std::string &path, std::string &stem);
+
+// A pipe, FIFO or /dev/stdin: its bytes can only be read once, front to back, and it has no size.
+// Such an input is opened once, by the buffer that parses it.
+bool IsPipeInput(duckdb::FileSystem &fs, const std::string &path);
+
+// Compression from the suffix, or else from the first bytes of the file (never read from a pipe)
+RDFCompression DetectCompression(duckdb::FileSystem &fs, const std::string &path);
+
+// Opens a file for reading. A gzip file is decompressed on the fly by the handle; a zstd file is
+// returned as it is, to be decompressed by RDFInputReader.
+duckdb::unique_ptr<duckdb::FileHandle> OpenRDFInput(duckdb::FileSystem &fs, const std::string &path,
+                                                    RDFCompression &compression);
+
+// For BGZF and seekable zstd files: frame starts roughly every range_size compressed bytes,
+// as [0, b1, ..., file_size]. Empty if the file is not made of independent frames.
+std::vector<duckdb::idx_t> FindFrameBoundaries(duckdb::FileHandle &handle, RDFCompression compression,
+                                               duckdb::idx_t file_size, duckdb::idx_t range_size);
+
+// Decompresses the frames starting in [start, end) of a BGZF or seekable zstd file (start and end
+// are frame starts) and hands out the lines that belong to them
+class FrameRangeReader : public LineSource {
+public:
+	FrameRangeReader(duckdb::FileHandle &handle, RDFCompression compression, duckdb::idx_t start, duckdb::idx_t end);
+	~FrameRangeReader() override;
+
+	duckdb::idx_t Read(char *buf, duckdb::idx_t len) override;
+
+	bool Finished() const override {
+		return _finished;
+	}
+
+private:
+	// Decompresses the next part of the current frame into _out; false at the end of the file
+	bool Decompress();
+	duckdb::idx_t CompressedPosition() const {
+		return _file_position - (_in_end - _in_pos);
+	}
+
+	duckdb::FileHandle &_handle;
+	RDFCompression _compression;
+	duckdb::idx_t _end;
+	// Compressed bytes read from the file and not yet decompressed
+	std::vector<char> _in;
+	duckdb::idx_t _in_pos = 0;
+	duckdb::idx_t _in_end = 0;
+	duckdb::idx_t _file_position;
+	bool _input_done = false;
+	// Decompressed bytes of one frame not yet handed out
+	std::vector<char> _out;
+	duckdb::idx_t _out_pos = 0;
+	duckdb::idx_t _out_end = 0;
+	// The frame being decompressed starts at or after the end of the range
+	bool _past_end = false;
+	bool _frame_start = true;
+	// Bytes of the current frame have been read, but not its end
+	bool _in_frame = false;
+	bool _skipping;
+	bool _finished = false;
+	// z_stream or ZSTD_DStream
+	void *_stream = nullptr;
+};
+
+// Reads a file opened by OpenRDFInput from its start. zstd input is decompressed with the linked
+// libzstd, so it does not need the file system of the parquet extension.
+class RDFInputReader {
+public:
+	RDFInputReader(duckdb::FileHandle &handle, RDFCompression compression);
+
+	// Returns 0 at the end of the input
+	duckdb::idx_t Read(char *buf, duckdb::idx_t len);
+
+private:
+	duckdb::FileHandle &_handle;
+	// Decodes the frames of a zstd file, [0, end of file) without dropping any line
+	std::unique_ptr<FrameRangeReader> _frames;
+};
+
+#endif // COMPRESSED_INPUT_H
@@ -0,0 +1,74 @@
+#ifndef HDT_BUFFER_H
+#define HDT_BUFFER_H
+
+#include "I_triples_buffer.hpp"
+#include "hdt_file.hpp"
+
+/*
+    Buffer for HDT files (see hdt_file.hpp). The triples are decoded straight from the bitmap
+    triples and the dictionary, in SPO order. A byte range set with SetByteRange is a range of
+    triple positions instead, so one file can be decoded by several threads.
+
+    An equality filter on subject or predicate is answered from the index: an unknown term
+    returns nothing, the triples of a subject are found by seeking, and pairs with another
+    predicate are skipped without decoding their objects.
+*/
+class HDTBuffer : public ITriplesBuffer {
+public:
+	HDTBuffer(std::string path, std::string base_uri, duckdb::FileSystem *fs = nullptr,
+	          const bool strict_parsing = true, const bool expand_prefixes = false,
+	          ITriplesBuffer::FileType file_type = ITriplesBuffer::HDT);
+
+	// Shares a file already opened for another range; must be called before StartParse
+	void SetFile(std::shared_ptr<HDTFile> file) {
+		_hdt = std::move(file);
+	}
+
+	void PopulateChunk(duckdb::DataChunk &output);
+	void StartParse();
+	duckdb::idx_t BytesRead() const override;
+
+private:
+	// Narrows the range to what the subject and predicate filters can match
+	void Seek();
+	void NextPair();
+	bool PassesFilter();
+	void WriteTriple();
+
+	std::shared_ptr<HDTFile> _hdt;
+	// Triples [_begin, _end) are decoded; _triple is the next, in pair _pair of subject _subject
+	duckdb::idx_t _begin = 0;
+	duckdb::idx_t _end = 0;
+	duckdb::idx_t _triple = 0;
+	duckdb::idx_t _pair = 0;
+	duckdb::idx_t _subject = 0;
+	bool _seeked = false;
+	// Set by a predicate equality filter: pairs with another predicate are skipped
+	uint64_t _predicate_filter = 0;
+
+	// The terms of the current triple. The subject and predicate are decoded again only when their
+	// ids change.
+	duckdb::idx_t _subject_id = 0;
+	uint64_t _predicate_id = 0;
+	std::string _subject_term;
+	std::string _predicate_term;
+	std::string _object_term;
+	// The subject and predicate as returned: without the _: of a blank node, compacted with
+	// compact_iris
+	const char *_subject_data = nullptr;
+	duckdb::idx_t _subject_len = 0;
+	const char *_predicate_data = nullptr;
+	duckdb::idx_t _predicate_len = 0;
+	// The object split into its lexical form, datatype and language
+	const char *_object_data = nullptr;
+	duckdb::idx_t _object_len = 0;
+	const char *_datatype = nullptr;
+	duckdb::idx_t _datatype_len = 0;
+	// The datatype as returned, a CURIE with compact_iris
+	const char *_datatype_term = nullptr;
+	duckdb::idx_t _datatype_term_len = 0;
+	const char *_lang = nullptr;
+	duckdb::idx_t _lang_len = 0;
+};
+
+#endif // HDT_BUFFER_H
@@ -0,0 +1,170 @@
+#ifndef HDT_FILE_H
+#define HDT_FILE_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "mapped_file.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+    HDT (Header-Dictionary-Triples) files, read in place. An HDT file holds a four section
+    dictionary (terms that are both subject and object, subjects, predicates, objects), each
+    section front coded in blocks of sorted strings, and the triples as bitmap triples: for each
+    subject in id order its predicates (array Y), and for each subject-predicate pair its objects
+    (array Z), with bitmaps marking the last entry of each list.
+
+    Triples are numbered by their position in Z, in SPO order. Any run of positions can be
+    decoded on its own, and the triples of a subject, or of a subject-predicate pair, are found
+    from rank and select on the bitmaps without reading the others.
+
+    Only what rdf2hdt writes by default is read: plain front coded sections, log arrays, plain
+    bitmaps and SPO order. The file is mapped into memory when it is local and uncompressed, and
+    read into memory otherwise. CRCs are not checked.
+*/
+
+// A sequence of fixed width integers, packed least significant bit first
+class HDTLogArray {
+public:
+	// Reads the array at pos; returns the position after it
+	const char *Load(const char *pos, const char *end);
+	duckdb::idx_t Count() const {
+		return _count;
+	}
+	uint64_t Get(duckdb::idx_t i) const;
+
+private:
+	const uint8_t *_data = nullptr;
+	uint8_t _bits = 0;
+	duckdb::idx_t _count = 0;
+};
+
+// A bitmap with rank and select, from a directory of counts built on first use
+class HDTBitmap {
+public:
+	const char *Load(const char *pos, const char *end);
+	duckdb::idx_t Size() const {
+		return _size;
+	}
+	bool Get(duckdb::idx_t i) const {
+		return (_data[i >> 3] >> (i & 7)) & 1;
+	}
+	// Set bits before position pos
+	duckdb::idx_t Rank(duckdb::idx_t pos) const;
+	// Position of the k-th set bit, from k = 1; Size() if there are fewer
+	duckdb::idx_t Select(duckdb::idx_t k) const;
+	duckdb::idx_t Ones() const;
+
+private:
+	static constexpr duckdb::idx_t BLOCK_BITS = 512;
+	uint64_t Word(duckdb::idx_t w) const;
+	void BuildDirectory() const;
+
+	const uint8_t *_data = nullptr;
+	duckdb::idx_t _size = 0;
+	// Set bits before each block of BLOCK_BITS bits, then the total
+	mutable std::vector<duckdb::idx_t> _directory;
+	mutable std::once_flag _directory_once;
+};
+
+// A dictionary section of sorted terms, ids from 1
+class HDTDictionarySection {
+public:
+	const char *Load(const char *pos, const char *end);
+	duckdb::idx_t Count() const {
+		return _count;
+	}
+	// Copies the term with an id into out
+	void Extract(duckdb::idx_t id, std::string &out) const;
+	// Id of a term; 0 if the section does not have it
+	duckdb::idx_t Locate(const char *term, duckdb::idx_t len) const;
+
+private:
+	const char *BlockStart(duckdb::idx_t block) const {
+		return _data + _blocks.Get(block);
+	}
+
+	HDTLogArray _blocks;
+	const char *_data = nullptr;
+	const char *_data_end = nullptr;
+	duckdb::idx_t _count = 0;
+	duckdb::idx_t _block_size = 0;
+};
+
+class HDTFile {
+public:
+	// Throws std::runtime_error if the file is not an HDT file this reader supports. With memory_map
+	// a local, uncompressed file is mapped; any other file is read into memory whole.
+	static std::shared_ptr<HDTFile> Open(duckdb::FileSystem &fs, const std::string &path, bool memory_map);
+	// The triple count the file's header states, read without loading the dictionary or the
+	// triples. 0 if the header has none.
+	static duckdb::idx_t ReadTripleCount(duckdb::FileSystem &fs, const std::string &path);
+
+	duckdb::idx_t Size() const {
+		return _size;
+	}
+	duckdb::idx_t TripleCount() const {
+		return _objects.Count();
+	}
+
+	// Terms of the ids found in the triples
+	void Subject(duckdb::idx_t id, std::string &out) const;
+	void Predicate(duckdb::idx_t id, std::string &out) const;
+	void Object(duckdb::idx_t id, std::string &out) const;
+	// Ids of terms, 0 for terms the file does not have
+	duckdb::idx_t LocateSubject(const std::string &term) const;
+	duckdb::idx_t LocatePredicate(const std::string &term) const;
+
+	// Navigation of the bitmap triples. Subjects are numbered from 1, pairs and triples from 0.
+	duckdb::idx_t PairOfTriple(duckdb::idx_t triple) const {
+		return _pair_ends.Rank(triple);
+	}
+	duckdb::idx_t SubjectOfPair(duckdb::idx_t pair) const {
+		return _subject_ends.Rank(pair) + 1;
+	}
+	// First pair of a subject; the pair count past the last subject
+	duckdb::idx_t FirstPair(duckdb::idx_t subject) const {
+		return subject <= 1 ? 0 : MinPair(_subject_ends.Select(subject - 1) + 1);
+	}
+	// First triple of a pair; the triple count past the last pair
+	duckdb::idx_t FirstTriple(duckdb::idx_t pair) const {
+		return pair == 0 ? 0 : duckdb::MinValue<duckdb::idx_t>(_pair_ends.Select(pair) + 1, TripleCount());
+	}
+	uint64_t PredicateOfPair(duckdb::idx_t pair) const {
+		return _predicates.Get(pair);
+	}
+	uint64_t ObjectOfTriple(duckdb::idx_t triple) const {
+		return _objects.Get(triple);
+	}
+	// Whether a triple is the last of its pair, and a pair the last of its subject
+	bool EndsPair(duckdb::idx_t triple) const {
+		return _pair_ends.Get(triple);
+	}
+	bool EndsSubject(duckdb::idx_t pair) const {
+		return _subject_ends.Get(pair);
+	}
+
+private:
+	void Load(const char *data, duckdb::idx_t size);
+	duckdb::idx_t MinPair(duckdb::idx_t pair) const {
+		return duckdb::MinValue<duckdb::idx_t>(pair, _predicates.Count());
+	}
+
+	// The mapped file, or its contents
+	duckdb::buffer_ptr<MappedFile> _mapping;
+	std::vector<char> _contents;
+	duckdb::idx_t _size = 0;
+
+	HDTDictionarySection _shared;
+	HDTDictionarySection _subjects;
+	HDTDictionarySection _predicate_terms;
+	HDTDictionarySection _objects_only;
+	HDTBitmap _subject_ends;
+	HDTBitmap _pair_ends;
+	HDTLogArray _predicates;
+	HDTLogArray _objects;
+};
+
+#endif // HDT_FILE_H
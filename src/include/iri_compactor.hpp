@@ -0,0 +1,52 @@
+#ifndef IRI_COMPACTOR_H
+#define IRI_COMPACTOR_H
+
+#include "duckdb.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Rewrites IRIs as CURIEs for read_rdf(..., compact_iris = true). The namespaces of the prefixes
+    are compiled into a trie over their bytes, so the longest namespace an IRI starts with is found
+    in a single pass over the IRI, however many prefixes there are. The CURIE is written into a
+    string owned by the caller, which is reused from term to term.
+
+    Prefixes come from the prefixes parameter and from the file's own declarations (@prefix in
+    Turtle and TriG, xmlns in RDF/XML), which are added as the parser reaches them. A declaration
+    in the file never replaces a prefix of the parameter.
+*/
+class IRICompactor {
+public:
+	IRICompactor();
+
+	// Maps the namespace ns to the prefix name. A prefix declared again takes its new namespace.
+	void AddPrefix(const std::string &name, const std::string &ns, bool from_file);
+	// Writes name:local to out and returns true if the IRI starts with a namespace
+	bool Compact(const char *iri, duckdb::idx_t len, std::string &out) const;
+	// Writes the IRI a CURIE stands for to out and returns true if its prefix is known
+	bool Expand(const std::string &curie, std::string &out) const;
+
+private:
+	static constexpr uint32_t NO_PREFIX = 0xFFFFFFFF;
+	struct Node {
+		// The prefix whose namespace ends at this node
+		uint32_t prefix = NO_PREFIX;
+		// Children by next byte; a handful at most, since namespaces share long runs of bytes
+		std::vector<std::pair<uint8_t, uint32_t>> children;
+	};
+	struct Prefix {
+		std::string name;
+		std::string ns;
+		bool from_file;
+	};
+	// The node reached by the bytes of ns, created if missing
+	uint32_t Insert(const std::string &ns);
+	uint32_t Child(uint32_t node, uint8_t byte) const;
+
+	std::vector<Node> _nodes;
+	std::vector<Prefix> _prefixes;
+	std::unordered_map<std::string, uint32_t> _by_name;
+};
+
+#endif // IRI_COMPACTOR_H
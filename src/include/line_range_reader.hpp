@@ -0,0 +1,90 @@
+#ifndef LINE_RANGE_READER_H
+#define LINE_RANGE_READER_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include <memory>
+#include <mutex>
+
+/*
+    Reads the lines of a file that belong to the byte range [start, end).
+
+    A line belongs to the range holding the byte *before* its first character (the line
+    starting at offset 0 belongs to the first range). A reader with start > 0 therefore
+    skips everything up to and including the first newline at or after start, and every
+    reader keeps going past end until it has handed out a newline at or after end.
+    Adjacent ranges partition the lines of a file without any reader looking behind its start.
+
+    The same rule lets an idle thread take over the unread tail of a range: lowering the end
+    of the range to some offset the reader has not reached yet makes [new end, old end) a
+    range of its own.
+*/
+
+// The end of a range and how far its reader has got, shared with threads that may split off its tail
+struct LineRangeClaim {
+	LineRangeClaim(duckdb::idx_t start, duckdb::idx_t end_p) : end(end_p), reserved(start) {
+	}
+
+	// Bytes left that no reader has reached yet
+	duckdb::idx_t Remaining();
+	// Lowers the end of the range to the middle of its unread part and returns that offset,
+	// with tail_end set to the old end. Returns INVALID_INDEX if less than 2 * min_size is left.
+	duckdb::idx_t SplitTail(duckdb::idx_t min_size, duckdb::idx_t &tail_end);
+
+	std::mutex lock;
+	duckdb::idx_t end;
+	// The reader has read, or is reading, everything before this offset
+	duckdb::idx_t reserved;
+	bool finished = false;
+};
+
+// The lines of one range of a file, as handed to a parser
+class LineSource {
+public:
+	virtual ~LineSource() = default;
+
+	// Copies up to len bytes of the range's lines into buf. Returns 0 once the range is exhausted.
+	virtual duckdb::idx_t Read(char *buf, duckdb::idx_t len) = 0;
+
+	// True once the last line of the range has been handed out (or the file ended)
+	virtual bool Finished() const = 0;
+};
+
+class LineRangeReader : public LineSource {
+public:
+	LineRangeReader(duckdb::FileHandle &handle, duckdb::idx_t start, std::shared_ptr<LineRangeClaim> claim);
+	// Reads the range from a file mapped into memory (see MappedFile)
+	LineRangeReader(const char *mapping, duckdb::idx_t mapping_size, duckdb::idx_t start,
+	                std::shared_ptr<LineRangeClaim> claim);
+
+	duckdb::idx_t Read(char *buf, duckdb::idx_t len) override;
+
+	// For a mapped file: the range's lines among the next len bytes of the mapping, without
+	// copying them. Successive calls return adjacent bytes. nullptr once the range is exhausted.
+	const char *ReadMapped(duckdb::idx_t len, duckdb::idx_t &length);
+
+	bool Finished() const override {
+		return _finished;
+	}
+
+private:
+	duckdb::idx_t ReadSome(char *buf, duckdb::idx_t len);
+	// Announces the next len bytes as being read and returns the current end of the range
+	duckdb::idx_t Reserve(duckdb::idx_t len);
+	// Takes the block of block_size bytes just read and sets offset and length to the part of it
+	// the range owns
+	void Trim(const char *block, duckdb::idx_t block_size, duckdb::idx_t end, duckdb::idx_t &offset,
+	          duckdb::idx_t &length);
+	void Finish();
+
+	duckdb::FileHandle *_handle = nullptr;
+	const char *_mapping = nullptr;
+	duckdb::idx_t _mapping_size = 0;
+	std::shared_ptr<LineRangeClaim> _claim;
+	// Absolute file offset of the next byte read from the handle
+	duckdb::idx_t _position;
+	bool _skipping;
+	bool _finished = false;
+};
+
+#endif // LINE_RANGE_READER_H
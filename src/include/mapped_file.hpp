@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/vector_buffer.hpp"
+#include <string>
+
+/*
+    A local file mapped into memory. The NTriples/NQuads fast path tokenizes the mapping in
+    place, and the terms it finds are written to the output as strings pointing into it rather
+    than copied into the vector's string heap. Every vector holding such strings keeps the
+    mapping alive as one of its buffers, so it is only unmapped once the last of them is gone.
+*/
+class MappedFile : public duckdb::VectorBuffer {
+public:
+	MappedFile(const char *data, duckdb::idx_t size);
+	~MappedFile() override;
+
+	// Maps the file at path, or returns nullptr if it can't be (not a local file, empty, no mmap)
+	static duckdb::buffer_ptr<MappedFile> Map(const std::string &path);
+
+	const char *Data() const {
+		return _data;
+	}
+	duckdb::idx_t Size() const {
+		return _size;
+	}
+	bool Contains(const char *data, duckdb::idx_t len) const {
+		return data >= _data && data + len <= _data + _size;
+	}
+
+private:
+	const char *_data;
+	duckdb::idx_t _size;
+};
+
+#endif // MAPPED_FILE_H
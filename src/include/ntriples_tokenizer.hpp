@@ -0,0 +1,46 @@
+#ifndef NTRIPLES_TOKENIZER_H
+#define NTRIPLES_TOKENIZER_H
+
+#include "duckdb.hpp"
+
+/*
+    Fast path for NTriples and NQuads. Lines are found, and the terms of a line split at their
+    delimiters, 16 bytes at a time (SSE2 or NEON, plain loops elsewhere). The tokenizer only
+    accepts the plain form of the grammar: ASCII lines without escapes, absolute IRIs, simple blank
+    node labels and language tags. Anything else, including every malformed line, is handed to
+    serd, so the fast path never changes what a file parses to or which errors it raises.
+*/
+
+// The terms of one statement in column order (graph, subject, predicate, object, object_datatype,
+// object_lang), pointing into the line; data == nullptr for an absent term
+struct NTriplesStatement {
+	const char *data[6];
+	duckdb::idx_t len[6];
+	bool literal;
+	// The term of the column is an IRI
+	bool iri[6];
+};
+
+class NTriplesTokenizer {
+public:
+	enum class Result : uint8_t { STATEMENT, EMPTY, FALLBACK };
+
+	explicit NTriplesTokenizer(bool quads) : _quads(quads) {
+	}
+
+	// Returns the '\n' ending the line that starts at pos, or end if the line is not complete.
+	// plain is cleared if the line holds a backslash or a non-ASCII byte.
+	static const char *FindLineEnd(const char *pos, const char *end, bool &plain);
+
+	// Splits a plain line (without its '\n'). EMPTY for blank and comment lines.
+	Result Tokenize(const char *pos, const char *end, NTriplesStatement &stmt) const;
+
+private:
+	const char *ReadIRI(const char *pos, const char *end, const char *&data, duckdb::idx_t &len) const;
+	const char *ReadBlank(const char *pos, const char *end, const char *&data, duckdb::idx_t &len) const;
+	const char *ReadLiteral(const char *pos, const char *end, NTriplesStatement &stmt) const;
+
+	bool _quads;
+};
+
+#endif // NTRIPLES_TOKENIZER_H
@@ -0,0 +1,129 @@
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+#include <string>
+#include <vector>
+
+/*
+    Parse cache. With cache_dir set, the first complete scan of a file also writes the statements
+    it parsed to a cache file, and later scans read them from there for as long as the file's
+    path, size and modification time, and the options that change what is parsed, still match.
+
+    A cache file holds row groups of up to ROW_GROUP_SIZE statements. Within a group every term
+    column is dictionary encoded: the distinct terms of the column, then one index per row, 0
+    standing for NULL. A scan reads only the columns it needs, and evaluates its filters once per
+    distinct term. The typed object columns are not stored; they are decoded from object and
+    object_datatype as they are when parsing.
+
+        header   "RDFCACH1", source size, source mtime, file type, strict_parsing,
+                 prefix_expansion, source path, IRI compaction
+        group    row count, offset of each of the 6 columns from the start of the group, then
+                 per column: term count, (length, bytes) per term, an index per row
+        footer   group count, offset of each group, offset of the footer, "RDFCEND1"
+
+    Numbers are written in native byte order: a cache belongs to the machine that wrote it. The
+    file is written under a temporary name and renamed once complete, so a scan that stops early
+    or fails never leaves a partial cache behind.
+*/
+
+// What a cache file must match to stand in for its source file
+struct ParseCacheKey {
+	std::string path;
+	duckdb::idx_t size = 0;
+	int64_t last_modified = 0;
+	uint8_t file_type = 0;
+	bool strict_parsing = true;
+	bool expand_prefixes = false;
+	// The prefixes IRIs are compacted with; empty without compact_iris
+	std::string compaction;
+
+	// Looks up the size and modification time of the source file
+	static ParseCacheKey Create(duckdb::FileSystem &fs, const std::string &path, uint8_t file_type,
+	                            bool strict_parsing, bool expand_prefixes, const std::string &compaction = "");
+};
+
+// Where the cache of a source file is kept in cache_dir
+std::string ParseCachePath(duckdb::FileSystem &fs, const std::string &cache_dir, const std::string &source_path);
+
+// A row group read from a cache file. Per column read: the distinct terms as a VARCHAR vector
+// whose entry 0 is NULL, and the index of each row's term. Columns not read are left empty.
+struct CacheRowGroup {
+	static constexpr duckdb::idx_t COLUMN_COUNT = 6;
+
+	duckdb::idx_t count = 0;
+	duckdb::unique_ptr<duckdb::Vector> terms[COLUMN_COUNT];
+	duckdb::idx_t term_count[COLUMN_COUNT] = {0, 0, 0, 0, 0, 0};
+	std::vector<uint32_t> indices[COLUMN_COUNT];
+};
+
+// Collects the statements of a parse into row groups
+class CacheRowGroupBuilder {
+public:
+	static constexpr duckdb::idx_t ROW_GROUP_SIZE = 122880;
+
+	// Appends the rows of a chunk holding the six term columns
+	void Append(duckdb::DataChunk &chunk);
+	duckdb::idx_t Count() const {
+		return _count;
+	}
+	// Encodes the rows appended since the last call as a row group, and starts the next one
+	std::string Serialize();
+
+private:
+	duckdb::StringHeap _heap;
+	duckdb::string_map_t<uint32_t> _ids[CacheRowGroup::COLUMN_COUNT];
+	// Terms by index, from 1
+	std::vector<duckdb::string_t> _terms[CacheRowGroup::COLUMN_COUNT];
+	std::vector<uint32_t> _indices[CacheRowGroup::COLUMN_COUNT];
+	duckdb::idx_t _count = 0;
+};
+
+// A complete cache file matching its source file
+class ParseCacheFile {
+public:
+	// nullptr if there is no cache for the key, or it is stale or incomplete
+	static duckdb::unique_ptr<ParseCacheFile> Open(duckdb::FileSystem &fs, const std::string &cache_path,
+	                                               const ParseCacheKey &key);
+
+	duckdb::idx_t GroupCount() const {
+		return _group_offsets.size() - 1;
+	}
+	duckdb::idx_t GroupSize(duckdb::idx_t group) const {
+		return _group_offsets[group + 1] - _group_offsets[group];
+	}
+	// Reads a row group, with the columns flagged in columns
+	duckdb::unique_ptr<CacheRowGroup> ReadGroup(duckdb::idx_t group, const bool *columns);
+
+private:
+	duckdb::unique_ptr<duckdb::FileHandle> _handle;
+	// Group starts, then the start of the footer
+	std::vector<duckdb::idx_t> _group_offsets;
+};
+
+// Writes a cache file under a temporary name, and gives it its name once it is complete
+class ParseCacheWriter {
+public:
+	ParseCacheWriter(duckdb::FileSystem &fs, const std::string &cache_path, const ParseCacheKey &key);
+	// Removes the temporary file unless Finish was reached
+	~ParseCacheWriter();
+
+	void WriteGroup(const std::string &group);
+	void Finish();
+
+private:
+	void Write(const std::string &data);
+
+	duckdb::FileSystem &_fs;
+	std::string _cache_path;
+	std::string _temp_path;
+	duckdb::unique_ptr<duckdb::FileHandle> _handle;
+	duckdb::idx_t _position = 0;
+	std::vector<duckdb::idx_t> _group_offsets;
+	bool _finished = false;
+};
+
+#endif // PARSE_CACHE_H
@@ -0,0 +1,56 @@
+#ifndef PIPELINED_BUFFER_H
+#define PIPELINED_BUFFER_H
+
+#include "I_triples_buffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+/*
+    Buffer for read_rdf(..., pipelined_parsing = true). The buffer it wraps, set up for a whole
+    file with its projection and filters, is run on a thread of its own, which parses the file
+    into chunks ahead of the scan. The scan thread only hands finished chunks on, so parsing one
+    large file that cannot be split overlaps with the operators above the scan.
+
+    Up to RING_SIZE parsed chunks wait in a ring between the two threads; the parser thread stops
+    when the ring is full. Each chunk is allocated afresh, so the output keeps its buffers alive
+    after the ring lets go of it. An error raised by the parser is rethrown by PopulateChunk once
+    the chunks parsed before it have been returned.
+*/
+class PipelinedBuffer : public ITriplesBuffer {
+public:
+	static constexpr duckdb::idx_t RING_SIZE = 4;
+
+	// inner must have been started, and given its column ids and filters
+	PipelinedBuffer(std::string path, std::unique_ptr<ITriplesBuffer> inner);
+	~PipelinedBuffer();
+
+	void PopulateChunk(duckdb::DataChunk &output) override;
+	void StartParse() override;
+	void Prefetch() override;
+	duckdb::idx_t BytesRead() const override {
+		return _bytes_read.load();
+	}
+
+private:
+	void Run();
+
+	std::unique_ptr<ITriplesBuffer> _inner;
+	duckdb::vector<duckdb::LogicalType> _types;
+	std::atomic<duckdb::idx_t> _bytes_read {0};
+
+	std::mutex _lock;
+	std::condition_variable _free_cv;
+	std::condition_variable _ready_cv;
+	std::thread _thread;
+	// Parsed chunks in file order; the parser thread has finished once _done is set
+	std::deque<duckdb::unique_ptr<duckdb::DataChunk>> _ready;
+	bool _done = false;
+	bool _stop = false;
+	std::exception_ptr _error;
+};
+
+#endif // PIPELINED_BUFFER_H
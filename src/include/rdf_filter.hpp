@@ -0,0 +1,124 @@
+#ifndef RDF_FILTER_H
+#define RDF_FILTER_H
+
+#include "duckdb.hpp"
+#include "duckdb/planner/table_filter.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
+#include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "typed_objects.hpp"
+#include <string>
+
+/*
+    Filters pushed down into read_rdf. Comparisons, IN lists, NULL checks and prefix, suffix and
+    contains matches on the terms are evaluated on the raw bytes of each term inside the parser
+    callbacks, and a statement that fails one is dropped before any of its terms is copied into the
+    output vectors. Everything else (other expressions on the terms, filters on the typed object
+    columns, and with encode_terms on the ids) is evaluated by DuckDB over each output chunk, see
+    RDFChunkFilter. Filters are exact: DuckDB does not re-check them after the scan.
+*/
+
+// A filter on one column. Terms are passed as (data, len), with data == nullptr for NULL.
+class RDFTermFilter {
+public:
+	// DEFERRED stands for an expression left to RDFChunkFilter, and passes every term
+	enum class Type : uint8_t {
+		COMPARE,
+		IS_NULL,
+		IS_NOT_NULL,
+		IN,
+		PREFIX,
+		SUFFIX,
+		CONTAINS,
+		AND,
+		OR,
+		DYNAMIC,
+		EXPRESSION,
+		DEFERRED
+	};
+
+	// type is the column's type; filters on non-VARCHAR columns are evaluated with MatchesValue
+	static duckdb::unique_ptr<RDFTermFilter> Create(duckdb::ClientContext &context, const duckdb::TableFilter &filter,
+	                                                const duckdb::LogicalType &type = duckdb::LogicalType::VARCHAR);
+
+	bool Matches(const char *data, duckdb::idx_t len) const;
+	bool MatchesValue(const duckdb::Value &value) const;
+	// False if no term between min and max (bytewise, inclusive) can pass, for skipping the blocks of
+	// a zone index. Terms of a block are never NULL.
+	bool MatchesRange(const std::string &min, const std::string &max) const;
+	// The constant the filter requires terms to equal, for readers that can look terms up
+	bool EqualityConstant(std::string &value) const;
+	// Picks up the current value of dynamic filters (join keys, top-N thresholds)
+	void Refresh();
+	// Whether some part of the filter is an expression evaluated per term, rather than on its bytes
+	bool HasExpression() const;
+	// Turns the expressions into DEFERRED, to be evaluated over whole chunks instead
+	void DeferExpressions();
+
+private:
+	friend class RDFStatementFilter;
+	explicit RDFTermFilter(Type type_p) : type(type_p) {
+	}
+	static duckdb::unique_ptr<RDFTermFilter> CreateExpression(duckdb::ClientContext &context,
+	                                                          duckdb::unique_ptr<duckdb::Expression> expr);
+
+	Type type;
+	duckdb::ExpressionType comparison = duckdb::ExpressionType::INVALID;
+	std::string constant;
+	// IN values, sorted bytewise
+	duckdb::vector<std::string> values;
+	duckdb::vector<duckdb::unique_ptr<RDFTermFilter>> children;
+	duckdb::shared_ptr<duckdb::DynamicFilterData> dynamic_data;
+	bool dynamic_active = false;
+	duckdb::optional_ptr<duckdb::ClientContext> context;
+	duckdb::unique_ptr<duckdb::ExpressionFilter> expression;
+};
+
+// The filters of one scan, by RDF column (graph, subject, predicate, object, object_datatype, object_lang).
+// Every buffer holds its own copy, so dynamic filters can be refreshed without locking per statement.
+class RDFStatementFilter {
+public:
+	// DuckDB keys the filters by position in column_ids. With encoded_terms, filters on the graph,
+	// subject, predicate and object columns are left to RDFChunkFilter, as those columns hold ids.
+	RDFStatementFilter(duckdb::ClientContext &context, const duckdb::TableFilterSet &filters,
+	                   const duckdb::vector<duckdb::column_t> &column_ids, bool encoded_terms = false);
+
+	bool HasFilter(duckdb::idx_t column) const {
+		return _columns[column] != nullptr;
+	}
+	bool Matches(duckdb::idx_t column, const char *data, duckdb::idx_t len) const {
+		return _columns[column]->Matches(data, len);
+	}
+	bool EqualityConstant(duckdb::idx_t column, std::string &value) const {
+		return _columns[column] && _columns[column]->EqualityConstant(value);
+	}
+	void Refresh();
+
+private:
+	duckdb::unique_ptr<RDFTermFilter> _columns[6];
+};
+
+// The filters the parsers leave to DuckDB, evaluated once per output chunk with an ExpressionExecutor:
+// those on the terms that have expressions, those on the typed object columns, and with encoded_terms
+// those on the graph, subject, predicate and object ids. One per thread.
+class RDFChunkFilter {
+public:
+	// nullptr when the parsers apply every filter. column_count is the number of columns before the
+	// file columns, whose filters select the files read instead.
+	static duckdb::unique_ptr<RDFChunkFilter> Create(duckdb::ClientContext &context,
+	                                                 const duckdb::TableFilterSet &filters,
+	                                                 const duckdb::vector<duckdb::column_t> &column_ids,
+	                                                 duckdb::idx_t column_count, bool encoded_terms);
+
+	// Drops the rows of chunk that fail a filter
+	void Apply(duckdb::DataChunk &chunk);
+
+private:
+	RDFChunkFilter(duckdb::ClientContext &context, duckdb::unique_ptr<duckdb::Expression> expression);
+
+	duckdb::unique_ptr<duckdb::Expression> _expression;
+	duckdb::ExpressionExecutor _executor;
+	duckdb::SelectionVector _sel;
+};
+
+#endif // RDF_FILTER_H
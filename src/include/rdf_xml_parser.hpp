@@ -18,6 +18,7 @@ struct RdfStatement {
 	std::string object;
 	std::string datatype; // XSD datatype URI, or empty
 	std::string language; // BCP 47 language tag, or empty
+	bool literal;         // object is a literal rather than a resource
 };
 
 class RdfXmlParser;
@@ -96,6 +97,15 @@ public:
 		_blank_node_prefix = prefix;
 	}
 
+	/// Bytes of character data held by the open elements, such as an XMLLiteral being collected.
+	size_t bufferedText() const {
+		size_t total = 0;
+		for (auto &frame : _stack) {
+			total += frame.text_buf.capacity();
+		}
+		return total;
+	}
+
 private:
 	friend struct RdfAttributes;
 	constexpr static char const *RDF_NS_XS = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
@@ -206,9 +216,9 @@ private:
 	static void onCharacters(void *ctx, const xmlChar *ch, int len);
 
 	void emitWithReification(const std::string &s, const std::string &p, const std::string &o, const std::string &dt,
-	                         const std::string &lang, const std::string &r_id);
+	                         const std::string &lang, const std::string &r_id, bool literal = false);
 	void emit(const std::string &s, const std::string &p, const std::string &o, const std::string &dt,
-	          const std::string &lang);
+	          const std::string &lang, bool literal = false);
 	std::string expandUri(const xmlChar *URI, const xmlChar *localname);
 
 	std::string trim(const std::string &s);
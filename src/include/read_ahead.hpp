@@ -0,0 +1,81 @@
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include "duckdb.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Read-ahead between a byte source (a file handle, a range of lines or a speculative chunk)
+    and a parser. Blocks of buffer_size bytes are read on a background thread into a small ring
+    of buffers, so the parser works on one block while the next ones are being read.
+
+    The first block is read on the parser's thread, and the background thread is only started if
+    the source has more: a small file costs no more than a direct read. Prefetch starts the
+    thread right away, for a file that will be parsed next.
+
+    Errors raised by the source on the background thread are rethrown by Read, after the blocks
+    read before them have been handed out.
+*/
+class ReadAheadBuffer {
+public:
+	// Copies up to len bytes into buf; returns 0 at the end. May return less than len before the end.
+	typedef std::function<duckdb::idx_t(char *, duckdb::idx_t)> Source;
+
+	static constexpr duckdb::idx_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+	static constexpr duckdb::idx_t MIN_BUFFER_SIZE = 4096;
+	// One block being parsed, one ready and one being read
+	static constexpr duckdb::idx_t BLOCK_COUNT = 3;
+
+	ReadAheadBuffer(Source source, duckdb::idx_t buffer_size);
+	~ReadAheadBuffer();
+
+	// Copies up to len bytes into buf. Less than len only at the end, like a file read.
+	duckdb::idx_t Read(char *buf, duckdb::idx_t len);
+
+	// True once every byte of the source has been handed out
+	bool Finished();
+
+	// Starts reading on the background thread before the first Read
+	void Prefetch();
+
+	// Bytes handed out by Read so far
+	duckdb::idx_t BytesRead() const {
+		return _bytes_read;
+	}
+
+private:
+	// Makes the next block current; false at the end of the source
+	bool NextBlock();
+	// Reads into a block until it is full or the source ends; sets end at the end
+	duckdb::idx_t FillBlock(std::vector<char> &block, bool &end);
+	void StartThread();
+	void Run();
+
+	Source _source;
+	std::vector<std::vector<char>> _blocks;
+	std::vector<duckdb::idx_t> _sizes;
+	// Block indices free to be filled, and filled blocks in source order
+	std::deque<duckdb::idx_t> _free;
+	std::deque<duckdb::idx_t> _ready;
+	// The block being handed out
+	duckdb::idx_t _current = duckdb::DConstants::INVALID_INDEX;
+	duckdb::idx_t _current_pos = 0;
+	duckdb::idx_t _bytes_read = 0;
+
+	std::mutex _lock;
+	std::condition_variable _free_cv;
+	std::condition_variable _ready_cv;
+	std::thread _thread;
+	bool _started = false;
+	bool _source_done = false;
+	bool _stop = false;
+	std::exception_ptr _error;
+};
+
+#endif // READ_AHEAD_H
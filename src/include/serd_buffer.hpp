@@ -6,7 +6,11 @@
 #include "duckdb/common/file_system.hpp"
 #include <serd/serd.h>
 #include "I_triples_buffer.hpp"
+#include "line_range_reader.hpp"
+#include "speculative_turtle.hpp"
+#include "ntriples_tokenizer.hpp"
 #include <memory>
+#include <vector>
 using namespace std;
 
 /*
@@ -22,11 +26,47 @@ public:
 
 	void PopulateChunk(duckdb::DataChunk &output);
 	void StartParse();
+	idx_t BytesRead() const override {
+		// A mapped file is tokenized in place
+		return _mapping ? _block_pos : ITriplesBuffer::BytesRead();
+	}
+
+	// Parses the byte range set with SetByteRange as one chunk of a speculatively split Turtle/TriG
+	// file, with the directives [0, header_end) replayed first. Errors are kept rather than thrown,
+	// since only the caller knows whether the chunk really started at a statement boundary.
+	void SetSpeculativeChunk(idx_t header_end, idx_t chunk_idx, bool last_chunk, idx_t skip_statements);
+	// The chunk's bytes ended in the middle of a statement
+	bool Truncated() const {
+		return _truncated;
+	}
+	const std::string &DeferredError() const {
+		return _deferred_error;
+	}
+	// Statements read by serd, including skipped ones
+	idx_t StatementCount() const {
+		return _statement_count;
+	}
+	// @prefix/@base (or PREFIX/BASE) directives read by serd
+	idx_t DirectiveCount() const {
+		return _directive_count;
+	}
+	// The directives serd reads in a Turtle text, such as the header of a speculatively split file
+	static idx_t CountDirectives(const std::string &text);
 
 private:
-	// Helper to write to vector
-	void WriteToVector(duckdb::Vector &vec, idx_t row_idx, const SerdNode *node);
-	string SafeString(const SerdNode *node);
+	void WriteNode(const RowTarget &target, idx_t col, const SerdNode *node);
+	bool IsGeneratedBlankId(const SerdNode *node) const;
+	// The bytes a term of a column is written to the output as, without copying where possible;
+	// nullptr for NULL
+	const char *TermBytes(idx_t col, const SerdNode *node, idx_t &len, std::string &scratch);
+	bool PassesFilter(const SerdNode *const terms[6]);
+	RDFObjectKind ObjectKind(const SerdNode *datatype);
+	void EndSpeculativeChunk(SerdStatus st);
+	// NTriples/NQuads fast path
+	void ParseLines();
+	void FillBlock();
+	void ParseLineWithSerd(const char *line, const char *line_end);
+	void AddStatement(NTriplesStatement &stmt);
 	static string SerdStatusToString(SerdStatus status);
 	static SerdStatus StatementCallback(void *user_data, SerdStatementFlags /*flags*/, const SerdNode *graph,
 	                                    const SerdNode *subject, const SerdNode *predicate, const SerdNode *object,
@@ -38,6 +78,43 @@ private:
 private:
 	std::unique_ptr<SerdReader, decltype(&serd_reader_free)> _reader;
 	std::unique_ptr<SerdEnv, decltype(&serd_env_free)> _env;
+	// Set when only a byte range of the file is parsed; read through _read_ahead
+	std::unique_ptr<LineSource> _range_reader;
+	// Reads the compressed frames of a range of a BGZF or seekable zstd file
+	std::unique_ptr<duckdb::FileHandle> _frame_handle;
+
+	// NTriples/NQuads are read in blocks and tokenized line by line; serd only sees the lines
+	// the tokenizer does not take
+	std::unique_ptr<NTriplesTokenizer> _tokenizer;
+	std::vector<char> _block;
+	// The bytes being tokenized: _block, or the part of a mapped file read so far
+	const char *_block_data = nullptr;
+	// Hands out the lines of a byte range of a mapped file
+	std::unique_ptr<LineRangeReader> _mapped_reader;
+	idx_t _block_pos = 0;
+	idx_t _block_end = 0;
+	bool _source_done = false;
+	// Lines read so far, for error messages
+	idx_t _line_number = 0;
+	std::string _fallback_line;
+
+	// Speculative chunk parsing
+	bool _speculative = false;
+	std::unique_ptr<SpeculativeChunkReader> _chunk_reader;
+	idx_t _header_end = 0;
+	bool _last_chunk = true;
+	idx_t _skip_statements = 0;
+	idx_t _statement_count = 0;
+	idx_t _directive_count = 0;
+	bool _truncated = false;
+	bool _error_at_end = false;
+	std::string _deferred_error;
+	// serd numbers the blank nodes it generates from b1 in every reader, so chunks after the
+	// first prefix theirs with the chunk index
+	std::string _genid_tag;
+	// Holds expanded or tagged terms while they are filtered or looked up
+	std::string _term_scratch;
+	std::string _datatype_scratch;
 
 	bool _has_error = false;
 	std::string _error_message;
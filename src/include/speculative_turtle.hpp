@@ -0,0 +1,112 @@
+#ifndef SPECULATIVE_TURTLE_H
+#define SPECULATIVE_TURTLE_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include <string>
+#include <vector>
+
+/*
+    Speculative parallel parsing of Turtle and TriG.
+
+    Unlike the line formats, a Turtle statement may span any number of lines, so a file can
+    only be cut where a statement is *guessed* to end: after a line whose last character
+    outside strings, IRIs and comments is '.' or '}', when the next line is not indented.
+    Every chunk is parsed on its own, with the file's leading directives replayed first.
+
+    A guessed boundary is only known to be right once the chunk before it, itself starting at
+    a known boundary, has parsed cleanly up to it. Until then a chunk's rows are staged. When a
+    chunk instead runs into its end in the middle of a statement, the next chunk started inside
+    that statement: its rows are discarded and the chunk is re-parsed through the next chunk's
+    end, skipping the statements it already produced. The re-parse also takes in the chunks
+    after that whose own parse failed, and at least doubles the chunk's span.
+
+    Only the leading directives are replayed, so a chunk that declares a prefix or base of its
+    own would leave the chunks after it parsed with the wrong ones. Once such a chunk is
+    confirmed, it absorbs every chunk after it and the rest of the file is parsed serially.
+*/
+
+// Returns the offset just past the @prefix/@base (or PREFIX/BASE) directives, blank lines and
+// comments at the start of a file. Those bytes are replayed ahead of every chunk.
+duckdb::idx_t ScanTurtleHeader(duckdb::FileHandle &handle, duckdb::idx_t file_size);
+
+// Guesses statement boundaries roughly every chunk_size bytes after the header.
+// Returns the chunk starts followed by file_size: [0, b1, ..., file_size].
+std::vector<duckdb::idx_t> GuessTurtleBoundaries(duckdb::FileHandle &handle, duckdb::idx_t header_end,
+                                                 duckdb::idx_t file_size, duckdb::idx_t chunk_size);
+
+// Hands serd the header bytes [0, header_end) followed by the chunk bytes [start, end)
+class SpeculativeChunkReader {
+public:
+	SpeculativeChunkReader(duckdb::FileHandle &handle, duckdb::idx_t header_end, duckdb::idx_t start,
+	                       duckdb::idx_t end);
+
+	duckdb::idx_t Read(char *buf, duckdb::idx_t len);
+
+	// Lines of the replayed header, which serd counts ahead of the chunk's own lines
+	duckdb::idx_t HeaderLines() const {
+		return _header_lines;
+	}
+
+private:
+	duckdb::FileHandle &_handle;
+	duckdb::idx_t _header_end;
+	duckdb::idx_t _header_position = 0;
+	duckdb::idx_t _header_lines = 0;
+	duckdb::idx_t _end;
+	duckdb::idx_t _position;
+};
+
+struct SpeculativeChunk {
+	duckdb::idx_t start = 0;
+	// Grows when the chunk absorbs its successor
+	duckdb::idx_t end = 0;
+	// The chunk starts at a real statement boundary; its rows can be returned
+	bool confirmed = false;
+	// The chunk started inside a statement of its predecessor; its rows are discarded
+	bool absorbed = false;
+	// Parsing reached the end of the chunk's bytes
+	bool finished = false;
+	// The last statement ran past the end of the chunk's bytes
+	bool truncated = false;
+	// The chunk's end was confirmed to be a statement boundary
+	bool resolved = false;
+	// Error raised while parsing; only reported once the chunk is confirmed
+	std::string error;
+	// Successors absorbed so far; each re-parse takes at least one more than that
+	duckdb::idx_t absorbed_chunks = 0;
+	// @prefix/@base (or PREFIX/BASE) directives the last parse read, those replayed included
+	duckdb::idx_t directives = 0;
+	// Statements produced by the last parse, skipped when the chunk is re-parsed
+	duckdb::idx_t statements = 0;
+	// Rows produced before the chunk was confirmed
+	duckdb::unique_ptr<duckdb::ColumnDataCollection> staged;
+};
+
+// Boundary bookkeeping for one file. Callers serialize access with the scan's global lock.
+class SpeculativeTurtleFile {
+public:
+	SpeculativeTurtleFile(duckdb::idx_t header_end, const std::vector<duckdb::idx_t> &boundaries);
+
+	// Records the outcome of parsing a chunk and propagates confirmations along the file.
+	// Staged rows of newly confirmed chunks are moved to ready; chunks that must be re-parsed
+	// with a larger end are added to reparse. Throws the error of a confirmed chunk.
+	void Finish(duckdb::idx_t chunk_idx, bool truncated, const std::string &error, duckdb::idx_t statements,
+	            duckdb::idx_t directives, std::vector<duckdb::unique_ptr<duckdb::ColumnDataCollection>> &ready,
+	            std::vector<duckdb::idx_t> &reparse);
+
+	bool IsLastChunk(duckdb::idx_t chunk_idx) const;
+
+	duckdb::idx_t header_end;
+	// Directives in [0, header_end), which every chunk reads
+	duckdb::idx_t header_directives = 0;
+	duckdb::idx_t file_size;
+	std::vector<SpeculativeChunk> chunks;
+
+private:
+	void Confirm(duckdb::idx_t chunk_idx, std::vector<duckdb::unique_ptr<duckdb::ColumnDataCollection>> &ready);
+	duckdb::idx_t NextChunk(duckdb::idx_t chunk_idx) const;
+};
+
+#endif // SPECULATIVE_TURTLE_H
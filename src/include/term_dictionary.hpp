@@ -0,0 +1,46 @@
+#ifndef TERM_DICTIONARY_H
+#define TERM_DICTIONARY_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+
+/*
+    Dictionary for the low-cardinality columns of a parse (graph, predicate, object_datatype,
+    object_lang). Each row records the id of its term instead of copying the term into the vector,
+    and each chunk is emitted as a dictionary vector over the terms seen so far, or as a constant
+    NULL vector when none of its rows has a value.
+*/
+class TermDictionary {
+public:
+	// A column with more distinct terms than this is written flat for the rest of the parse
+	static constexpr duckdb::idx_t MAX_TERMS = 1024;
+
+	TermDictionary();
+
+	bool Active() const {
+		return _active;
+	}
+	// Records the term of a row, data == nullptr for NULL. Returns false when the term does not
+	// fit: the chunk's earlier rows have then been written flat to vec and this one must be too.
+	bool Add(duckdb::Vector &vec, duckdb::idx_t row, const char *data, duckdb::idx_t len);
+	// Turns the rows added since the last call into a dictionary or constant vector
+	void Emit(duckdb::Vector &vec, duckdb::idx_t count);
+
+private:
+	void Deactivate(duckdb::Vector &vec, duckdb::idx_t count);
+
+	bool _active = true;
+	duckdb::StringHeap _heap;
+	duckdb::string_map_t<uint32_t> _ids;
+	// Terms by id; the NULL entry, if any, is at _null_id
+	duckdb::vector<duckdb::string_t> _terms;
+	uint32_t _null_id;
+	// Rebuilt only when new terms appear, so consecutive chunks share one dictionary
+	duckdb::buffer_ptr<duckdb::VectorChildBuffer> _dictionary;
+	duckdb::idx_t _dictionary_size = 0;
+	duckdb::SelectionVector _sel;
+	bool _all_null = true;
+};
+
+#endif // TERM_DICTIONARY_H
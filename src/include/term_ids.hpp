@@ -0,0 +1,114 @@
+#ifndef TERM_IDS_H
+#define TERM_IDS_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "rdf_filter.hpp"
+#include <mutex>
+#include <string>
+
+/*
+    Integer ids for RDF terms, returned by read_rdf(..., encode_terms = true) in place of the
+    graph, subject, predicate and object strings. There is one dictionary per database, kept in
+    its object cache, so every scan gives a term the same id and scans can be joined on their ids;
+    rdf_terms() lists the dictionary.
+
+    A term is its value with its datatype and language, so "30"^^xsd:integer and "30" get
+    different ids, while an IRI gets the same id as subject, predicate or object. The dictionary is
+    split into shards by the hash of the term, each with its own lock, and the low bits of an id
+    are its shard, so threads only meet when they add terms to the same shard at the same time.
+*/
+class RDFTermIds : public duckdb::ObjectCacheEntry {
+public:
+	static constexpr duckdb::idx_t SHARD_BITS = 6;
+	static constexpr duckdb::idx_t SHARD_COUNT = 1 << SHARD_BITS;
+
+	// The database's dictionary, created on first use
+	static duckdb::shared_ptr<RDFTermIds> Get(duckdb::ClientContext &context);
+
+	// The key of a term: its value, and its datatype and language (nullptr when absent)
+	static void MakeKey(const duckdb::string_t &value, const duckdb::string_t *datatype,
+	                    const duckdb::string_t *lang, std::string &key);
+
+	// Ids of up to STANDARD_VECTOR_SIZE keys; keys not seen before are given new ids.
+	// Each shard is locked once per call.
+	void Lookup(const duckdb::string_t *keys, duckdb::idx_t count, int64_t *ids);
+
+	// Appends the terms of a shard from position pos on to output (id, term, datatype, lang) while
+	// it has room. Returns the number of terms appended.
+	duckdb::idx_t Scan(duckdb::idx_t shard, duckdb::idx_t pos, duckdb::DataChunk &output);
+
+	std::string GetObjectType() override {
+		return ObjectType();
+	}
+	static std::string ObjectType() {
+		return "rdf_term_ids";
+	}
+	// Never evicted: ids handed out must keep their meaning. The dictionary grows with every new
+	// term until the database is closed.
+	duckdb::optional_idx GetEstimatedCacheMemory() const override {
+		return duckdb::optional_idx();
+	}
+
+private:
+	struct Shard {
+		std::mutex lock;
+		duckdb::StringHeap heap;
+		duckdb::string_map_t<int64_t> ids;
+		// Keys by position, the id shifted right by SHARD_BITS
+		duckdb::vector<duckdb::string_t> keys;
+	};
+	Shard _shards[SHARD_COUNT];
+};
+
+// Encodes the term columns of one thread's chunks into ids. Filters on the encoded columns are
+// applied to the ids afterwards by RDFChunkFilter, since the parsers only see the terms.
+class RDFTermEncoder {
+public:
+	RDFTermEncoder(duckdb::shared_ptr<RDFTermIds> ids, const duckdb::vector<duckdb::column_t> &column_ids);
+
+	// Whether a column is returned as ids
+	static bool IsEncodedColumn(duckdb::column_t col) {
+		return col <= 3;
+	}
+	// The columns the parsers return: those of the scan, then object_datatype and object_lang when
+	// the object is encoded without them
+	const duckdb::vector<duckdb::column_t> &TermColumnIds() const {
+		return _term_column_ids;
+	}
+	// Types of the chunk the parsers fill, given the types of the scan's output
+	duckdb::vector<duckdb::LogicalType> TermTypes(const duckdb::vector<duckdb::LogicalType> &output_types) const;
+
+	// Writes the rows of terms to output, with ids for the encoded columns
+	void Encode(duckdb::DataChunk &terms, duckdb::DataChunk &output);
+
+private:
+	void EncodeColumn(duckdb::DataChunk &terms, duckdb::idx_t slot, duckdb::Vector &result);
+
+	duckdb::shared_ptr<RDFTermIds> _ids;
+	duckdb::vector<duckdb::column_t> _term_column_ids;
+	// Slots of object_datatype and object_lang in the term chunk, -1 when not returned
+	int _datatype_slot = -1;
+	int _lang_slot = -1;
+
+	// The last key of each encoded column and its id: runs of one subject or predicate are
+	// looked up once
+	struct LastTerm {
+		bool valid = false;
+		std::string key;
+		int64_t id = 0;
+	};
+	LastTerm _last[4];
+	// Keys of the rows being encoded, packed into _key_data, and for each row the index of its key
+	// (INVALID_INDEX for rows sharing the previous chunk's last key)
+	std::string _key;
+	std::string _key_data;
+	duckdb::vector<duckdb::idx_t> _key_ends;
+	duckdb::vector<duckdb::string_t> _keys;
+	duckdb::vector<int64_t> _key_ids;
+	duckdb::vector<duckdb::idx_t> _row_keys;
+};
+
+#endif // TERM_IDS_H
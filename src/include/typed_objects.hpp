@@ -0,0 +1,46 @@
+#ifndef TYPED_OBJECTS_H
+#define TYPED_OBJECTS_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+
+/*
+    Typed object columns: with typed_objects = true, literals of the common XSD datatypes are also
+    returned as native values in the columns object_integer, object_double, object_boolean,
+    object_date and object_datetime. The lexical forms are collected while a chunk is parsed and
+    decoded together, one datatype at a time, when the chunk is complete.
+*/
+
+// XSD datatypes decoded into typed columns
+enum class RDFObjectKind : uint8_t { NONE = 0, INTEGER, DECIMAL, BOOLEAN, DATE, DATETIME };
+
+// Maps a full datatype IRI to the kind of value it holds
+RDFObjectKind ClassifyDatatype(const char *iri, duckdb::idx_t len);
+
+class TypedObjectBatch {
+public:
+	// Column ids of the typed columns follow the six term columns
+	static constexpr duckdb::idx_t FIRST_COLUMN = 6;
+	static constexpr duckdb::idx_t COLUMN_COUNT = 5;
+	static void AddColumns(duckdb::vector<duckdb::LogicalType> &types, duckdb::vector<std::string> &names);
+	static duckdb::LogicalType ColumnType(duckdb::idx_t typed_col);
+	// The value of one typed column for a single object, for filters checked before the row is written
+	static duckdb::Value DecodeValue(duckdb::idx_t typed_col, RDFObjectKind kind, const char *data, duckdb::idx_t len);
+
+	TypedObjectBatch();
+
+	// Records the lexical form of a row's object
+	void Add(duckdb::idx_t row, RDFObjectKind kind, const char *data, duckdb::idx_t len);
+	// Writes the typed columns of rows [start, end) of the chunk; slots maps the typed columns to the
+	// chunk's vectors (-1 = not projected). Rows not recorded are NULL. Clears the batch.
+	void Decode(duckdb::DataChunk &chunk, const int8_t *slots, duckdb::idx_t start, duckdb::idx_t end);
+
+private:
+	static constexpr duckdb::idx_t KIND_COUNT = 6;
+	duckdb::SelectionVector _rows[KIND_COUNT];
+	duckdb::idx_t _counts[KIND_COUNT];
+	duckdb::string_t _lexical[STANDARD_VECTOR_SIZE];
+	duckdb::StringHeap _heap;
+};
+
+#endif // TYPED_OBJECTS_H
@@ -5,6 +5,7 @@
 #include "duckdb.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "rdf_xml_parser.hpp"
+#include <vector>
 
 class XMLBuffer : public ITriplesBuffer {
 public:
@@ -18,12 +19,19 @@ public:
 	void StartParse();
 
 private:
-	constexpr static size_t PARSING_CHUNK_SIZE = 4096;
-	void writeToVector(duckdb::Vector &vec, idx_t row_idx, const std::string &field);
+	constexpr static size_t PARSING_CHUNK_SIZE = 64 * 1024;
+	// Filters on the terms as written, data[col] nullptr for NULL
+	bool passesFilter(const RdfStatement &stmt, const char *const data[6], const idx_t len[6]) const;
 	void statementCallback(const RdfStatement &stmt);
 	void namespaceCallback(const std::string &prefix, const std::string &uri);
 	void errorCallback(const std::string &msg);
+	// Charges the character data the parser holds, which a large XMLLiteral can make any size, to
+	// DuckDB's memory limit; the memory is reserved in the buffer manager until it is released
+	void chargeText();
+	duckdb::idx_t _charged_text = 0;
 	RdfXmlParser _parser;
+	// Bytes handed to the parser at a time
+	std::vector<char> _chunk;
 };
 
 #endif // XML_BUFFER_H
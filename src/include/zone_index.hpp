@@ -0,0 +1,64 @@
+#ifndef ZONE_INDEX_H
+#define ZONE_INDEX_H
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include <string>
+#include <vector>
+
+/*
+    Zone map index of an uncompressed NTriples or NQuads file, written by rdf_build_index and kept
+    beside the file as <file>.rdfidx. The file is cut into blocks of whole lines of about
+    block_size bytes, and per block the index holds its byte offsets, its statement count and the
+    smallest and largest subject and predicate. A scan skips the blocks whose bounds fail its
+    filters on subject or predicate, and splits the rest at block boundaries. Bounds only prune
+    where a file is sorted or clustered on a column, but they are always correct.
+
+    Bounds are taken from the lines the NTriples fast path can split (see NTriplesTokenizer),
+    whose terms are written as they appear in the file. A block holding any other statement line
+    has no bounds and is always read.
+
+        header   "RDFZIDX1", source size, source mtime, quads, block count
+        block    start, end, statement count, bounded, then (length, bytes) of the smallest
+                 subject, largest subject, smallest predicate and largest predicate
+        trailer  "RDFZEND1"
+
+    Numbers are written in native byte order. The index is written under a temporary name and
+    renamed once complete, and an index whose size or modification time no longer match its
+    file is ignored.
+*/
+
+struct ZoneIndexBlock {
+	// Offset of the first line of the block, and of the line after its last
+	duckdb::idx_t start = 0;
+	duckdb::idx_t end = 0;
+	duckdb::idx_t statements = 0;
+	// False when a statement of the block is left out of the bounds below
+	bool bounded = true;
+	std::string min_subject;
+	std::string max_subject;
+	std::string min_predicate;
+	std::string max_predicate;
+};
+
+class ZoneIndex {
+public:
+	static constexpr duckdb::idx_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+	static std::string IndexPath(const std::string &source_path) {
+		return source_path + ".rdfidx";
+	}
+	// nullptr if the file has no index, or it is stale, unreadable or of the other format
+	static duckdb::unique_ptr<ZoneIndex> Open(duckdb::FileSystem &fs, const std::string &source_path, bool quads);
+	// Reads the whole file and writes its index
+	static duckdb::unique_ptr<ZoneIndex> Build(duckdb::FileSystem &fs, const std::string &source_path, bool quads,
+	                                           duckdb::idx_t block_size);
+
+	duckdb::idx_t StatementCount() const;
+	// Every block is bounded and its subjects follow those of the block before
+	bool SubjectsSorted() const;
+
+	std::vector<ZoneIndexBlock> blocks;
+};
+
+#endif // ZONE_INDEX_H
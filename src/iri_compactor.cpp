@@ -0,0 +1,99 @@
+#include "include/iri_compactor.hpp"
+
+using namespace duckdb;
+
+IRICompactor::IRICompactor() : _nodes(1) {
+}
+
+uint32_t IRICompactor::Child(uint32_t node, uint8_t byte) const {
+	for (auto &child : _nodes[node].children) {
+		if (child.first == byte) {
+			return child.second;
+		}
+	}
+	return 0;
+}
+
+uint32_t IRICompactor::Insert(const std::string &ns) {
+	uint32_t node = 0;
+	for (auto c : ns) {
+		auto next = Child(node, (uint8_t)c);
+		if (next == 0) {
+			next = (uint32_t)_nodes.size();
+			_nodes[node].children.emplace_back((uint8_t)c, next);
+			_nodes.emplace_back();
+		}
+		node = next;
+	}
+	return node;
+}
+
+void IRICompactor::AddPrefix(const std::string &name, const std::string &ns, bool from_file) {
+	// An empty namespace would turn every IRI into a CURIE
+	if (ns.empty()) {
+		return;
+	}
+	uint32_t prefix;
+	auto entry = _by_name.find(name);
+	if (entry != _by_name.end()) {
+		prefix = entry->second;
+		auto &existing = _prefixes[prefix];
+		if (from_file && !existing.from_file) {
+			return;
+		}
+		// The old namespace no longer maps to this name
+		auto old_node = Insert(existing.ns);
+		if (_nodes[old_node].prefix == prefix) {
+			_nodes[old_node].prefix = NO_PREFIX;
+		}
+		existing.ns = ns;
+		existing.from_file = from_file;
+	} else {
+		prefix = (uint32_t)_prefixes.size();
+		_prefixes.push_back(Prefix {name, ns, from_file});
+		_by_name[name] = prefix;
+	}
+	auto &node = _nodes[Insert(ns)];
+	if (node.prefix != NO_PREFIX && from_file && !_prefixes[node.prefix].from_file) {
+		return;
+	}
+	node.prefix = prefix;
+}
+
+bool IRICompactor::Compact(const char *iri, idx_t len, std::string &out) const {
+	uint32_t node = 0;
+	uint32_t match = NO_PREFIX;
+	idx_t match_len = 0;
+	for (idx_t i = 0; i < len; i++) {
+		node = Child(node, (uint8_t)iri[i]);
+		if (node == 0) {
+			break;
+		}
+		if (_nodes[node].prefix != NO_PREFIX) {
+			match = _nodes[node].prefix;
+			match_len = i + 1;
+		}
+	}
+	if (match == NO_PREFIX) {
+		return false;
+	}
+	auto &name = _prefixes[match].name;
+	out.assign(name);
+	out.push_back(':');
+	out.append(iri + match_len, len - match_len);
+	return true;
+}
+
+bool IRICompactor::Expand(const std::string &curie, std::string &out) const {
+	auto colon = curie.find(':');
+	if (colon == std::string::npos) {
+		return false;
+	}
+	auto entry = _by_name.find(curie.substr(0, colon));
+	if (entry == _by_name.end()) {
+		return false;
+	}
+	out = _prefixes[entry->second].ns;
+	out.append(curie, colon + 1, std::string::npos);
+	return true;
+}
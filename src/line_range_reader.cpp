@@ -0,0 +1,131 @@
+#include "include/line_range_reader.hpp"
+#include <algorithm>
+#include <cstring>
+
+duckdb::idx_t LineRangeClaim::Remaining() {
+	std::lock_guard<std::mutex> lk(lock);
+	return !finished && end > reserved ? end - reserved : 0;
+}
+
+duckdb::idx_t LineRangeClaim::SplitTail(duckdb::idx_t min_size, duckdb::idx_t &tail_end) {
+	std::lock_guard<std::mutex> lk(lock);
+	if (finished || end <= reserved || end - reserved < 2 * min_size) {
+		return duckdb::DConstants::INVALID_INDEX;
+	}
+	tail_end = end;
+	end = reserved + (end - reserved) / 2;
+	return end;
+}
+
+LineRangeReader::LineRangeReader(duckdb::FileHandle &handle, duckdb::idx_t start,
+                                 std::shared_ptr<LineRangeClaim> claim)
+    : _handle(&handle), _claim(std::move(claim)), _position(start), _skipping(start > 0) {
+	_handle->Seek(start);
+}
+
+LineRangeReader::LineRangeReader(const char *mapping, duckdb::idx_t mapping_size, duckdb::idx_t start,
+                                 std::shared_ptr<LineRangeClaim> claim)
+    : _mapping(mapping), _mapping_size(mapping_size), _claim(std::move(claim)), _position(start),
+      _skipping(start > 0) {
+}
+
+void LineRangeReader::Finish() {
+	_finished = true;
+	std::lock_guard<std::mutex> lk(_claim->lock);
+	_claim->finished = true;
+}
+
+duckdb::idx_t LineRangeReader::Read(char *buf, duckdb::idx_t len) {
+	// serd takes a short read for the end of the stream, so only the last read may come up short
+	duckdb::idx_t filled = 0;
+	while (filled < len && !_finished) {
+		filled += ReadSome(buf + filled, len - filled);
+	}
+	return filled;
+}
+
+duckdb::idx_t LineRangeReader::Reserve(duckdb::idx_t len) {
+	// Announce the bytes about to be read, so the end is never moved below them
+	std::lock_guard<std::mutex> lk(_claim->lock);
+	_claim->reserved = _position + len;
+	return _claim->end;
+}
+
+duckdb::idx_t LineRangeReader::ReadSome(char *buf, duckdb::idx_t len) {
+	while (!_finished) {
+		duckdb::idx_t end = Reserve(len);
+		int64_t read;
+		if (_mapping) {
+			read = (int64_t)std::min<duckdb::idx_t>(len, _mapping_size - std::min(_position, _mapping_size));
+			memcpy(buf, _mapping + _position, (size_t)read);
+		} else {
+			read = _handle->Read(buf, len);
+		}
+		if (read <= 0) {
+			Finish();
+			return 0;
+		}
+		duckdb::idx_t offset, length;
+		Trim(buf, (duckdb::idx_t)read, end, offset, length);
+		if (length == 0) {
+			continue;
+		}
+		if (offset > 0) {
+			memmove(buf, buf + offset, length);
+		}
+		return length;
+	}
+	return 0;
+}
+
+const char *LineRangeReader::ReadMapped(duckdb::idx_t len, duckdb::idx_t &length) {
+	while (!_finished) {
+		duckdb::idx_t end = Reserve(len);
+		duckdb::idx_t block_size = std::min<duckdb::idx_t>(len, _mapping_size - std::min(_position, _mapping_size));
+		if (block_size == 0) {
+			Finish();
+			return nullptr;
+		}
+		const char *block = _mapping + _position;
+		duckdb::idx_t offset;
+		Trim(block, block_size, end, offset, length);
+		if (length > 0) {
+			return block + offset;
+		}
+	}
+	return nullptr;
+}
+
+void LineRangeReader::Trim(const char *block, duckdb::idx_t block_size, duckdb::idx_t end, duckdb::idx_t &offset,
+                           duckdb::idx_t &length) {
+	duckdb::idx_t block_start = _position;
+	_position += block_size;
+	offset = 0;
+	length = 0;
+
+	// Drop the tail of the line owned by the previous range
+	if (_skipping) {
+		auto nl = static_cast<const char *>(memchr(block, '\n', block_size));
+		if (!nl) {
+			return;
+		}
+		offset = (duckdb::idx_t)(nl - block) + 1;
+		_skipping = false;
+		if (block_start + offset - 1 >= end) {
+			// No line starts inside this range
+			Finish();
+			return;
+		}
+	}
+
+	// Once past the end of the range, stop after the first newline at or after it
+	length = block_size - offset;
+	if (_position > end) {
+		duckdb::idx_t search_from = end > block_start + offset ? end - block_start : offset;
+		auto nl = static_cast<const char *>(memchr(block + search_from, '\n', block_size - search_from));
+		if (nl) {
+			length = (duckdb::idx_t)(nl - block) + 1 - offset;
+			Finish();
+		}
+	}
+}
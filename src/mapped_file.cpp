@@ -0,0 +1,48 @@
+#include "include/mapped_file.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using duckdb::idx_t;
+
+MappedFile::MappedFile(const char *data, idx_t size)
+    : duckdb::VectorBuffer(duckdb::VectorBufferType::OPAQUE_BUFFER), _data(data), _size(size) {
+}
+
+#ifndef _WIN32
+MappedFile::~MappedFile() {
+	munmap(const_cast<char *>(_data), _size);
+}
+
+duckdb::buffer_ptr<MappedFile> MappedFile::Map(const std::string &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	auto size = (idx_t)st.st_size;
+	void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+	madvise(data, size, MADV_SEQUENTIAL);
+	return duckdb::make_buffer<MappedFile>(static_cast<const char *>(data), size);
+}
+#else
+MappedFile::~MappedFile() {
+}
+
+duckdb::buffer_ptr<MappedFile> MappedFile::Map(const std::string &path) {
+	return nullptr;
+}
+#endif
@@ -0,0 +1,321 @@
+#include "include/ntriples_tokenizer.hpp"
+#include <cstring>
+
+using duckdb::idx_t;
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define NTRIPLES_SIMD
+// One mask bit per byte
+static const int BITS_PER_BYTE = 1;
+typedef __m128i Block;
+static inline Block LoadBlock(const char *pos) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+}
+static inline uint64_t Equal(Block block, char c) {
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+}
+// Bytes below c as signed values, which includes every non-ASCII byte
+static inline uint64_t Below(Block block, char c) {
+	return (uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(block, _mm_set1_epi8(c)));
+}
+#elif defined(__GNUC__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NTRIPLES_SIMD
+// Four mask bits per byte: narrowing the compare result by a 4 bit shift packs it into 64 bits
+static const int BITS_PER_BYTE = 4;
+typedef int8x16_t Block;
+static inline uint64_t ToMask(uint8x16_t matches) {
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+static inline Block LoadBlock(const char *pos) {
+	return vld1q_s8(reinterpret_cast<const int8_t *>(pos));
+}
+static inline uint64_t Equal(Block block, char c) {
+	return ToMask(vceqq_s8(block, vdupq_n_s8(c)));
+}
+static inline uint64_t Below(Block block, char c) {
+	return ToMask(vcltq_s8(block, vdupq_n_s8(c)));
+}
+#endif
+
+#ifdef NTRIPLES_SIMD
+static const idx_t BLOCK_SIZE = 16;
+static inline idx_t FirstByte(uint64_t mask) {
+	return (idx_t)__builtin_ctzll(mask) / BITS_PER_BYTE;
+}
+#endif
+
+const char *NTriplesTokenizer::FindLineEnd(const char *pos, const char *end, bool &plain) {
+#ifdef NTRIPLES_SIMD
+	while ((idx_t)(end - pos) >= BLOCK_SIZE) {
+		auto block = LoadBlock(pos);
+		auto newline = Equal(block, '\n');
+		auto special = Equal(block, '\\') | Below(block, 0);
+		if (newline) {
+			auto line_end = FirstByte(newline);
+			if (special && FirstByte(special) < line_end) {
+				plain = false;
+			}
+			return pos + line_end;
+		}
+		if (special) {
+			plain = false;
+		}
+		pos += BLOCK_SIZE;
+	}
+#endif
+	for (; pos < end; pos++) {
+		if (*pos == '\n') {
+			return pos;
+		}
+		if (*pos == '\\' || (unsigned char)*pos >= 0x80) {
+			plain = false;
+		}
+	}
+	return end;
+}
+
+static inline bool IsSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char *SkipSpace(const char *pos, const char *end) {
+	while (pos < end && IsSpace(*pos)) {
+		pos++;
+	}
+	return pos;
+}
+
+static inline bool IsAlpha(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static inline bool IsAlnum(char c) {
+	return IsAlpha(c) || (c >= '0' && c <= '9');
+}
+
+static inline bool IsInvalidIRIByte(char c) {
+	switch (c) {
+	case '<':
+	case '"':
+	case '{':
+	case '}':
+	case '|':
+	case '^':
+	case '`':
+	case '\\':
+		return true;
+	default:
+		return (unsigned char)c <= 0x20;
+	}
+}
+
+// Returns the '>' closing an IRI, or nullptr if a byte IRIs may not hold (or the end) comes first
+static const char *ScanIRI(const char *pos, const char *end) {
+#ifdef NTRIPLES_SIMD
+	while ((idx_t)(end - pos) >= BLOCK_SIZE) {
+		auto block = LoadBlock(pos);
+		auto close = Equal(block, '>');
+		auto invalid = Below(block, 0x21) | Equal(block, '<') | Equal(block, '"') | Equal(block, '{') |
+		               Equal(block, '}') | Equal(block, '|') | Equal(block, '^') | Equal(block, '`') |
+		               Equal(block, '\\');
+		if (close | invalid) {
+			auto first = FirstByte(close | invalid);
+			return close && FirstByte(close) == first ? pos + first : nullptr;
+		}
+		pos += BLOCK_SIZE;
+	}
+#endif
+	for (; pos < end; pos++) {
+		if (*pos == '>') {
+			return pos;
+		}
+		if (IsInvalidIRIByte(*pos)) {
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
+
+// Returns the '"' closing a string, or nullptr if a carriage return (or the end) comes first
+static const char *ScanString(const char *pos, const char *end) {
+#ifdef NTRIPLES_SIMD
+	while ((idx_t)(end - pos) >= BLOCK_SIZE) {
+		auto block = LoadBlock(pos);
+		auto close = Equal(block, '"');
+		auto invalid = Equal(block, '\r');
+		if (close | invalid) {
+			auto first = FirstByte(close | invalid);
+			return close && FirstByte(close) == first ? pos + first : nullptr;
+		}
+		pos += BLOCK_SIZE;
+	}
+#endif
+	for (; pos < end; pos++) {
+		if (*pos == '"') {
+			return pos;
+		}
+		if (*pos == '\r') {
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
+
+// Reads <iri> at pos and returns the byte after it, or nullptr. Relative IRIs are left to serd.
+const char *NTriplesTokenizer::ReadIRI(const char *pos, const char *end, const char *&data, idx_t &len) const {
+	auto start = pos + 1;
+	auto close = ScanIRI(start, end);
+	if (!close || close == start || !IsAlpha(*start)) {
+		return nullptr;
+	}
+	auto scheme = start + 1;
+	while (scheme < close && (IsAlnum(*scheme) || *scheme == '+' || *scheme == '-' || *scheme == '.')) {
+		scheme++;
+	}
+	if (scheme == close || *scheme != ':') {
+		return nullptr;
+	}
+	data = start;
+	len = (idx_t)(close - start);
+	return close + 1;
+}
+
+// Reads _:label at pos. Labels with dots or non-ASCII characters are left to serd.
+const char *NTriplesTokenizer::ReadBlank(const char *pos, const char *end, const char *&data, idx_t &len) const {
+	if (end - pos < 3 || pos[1] != ':') {
+		return nullptr;
+	}
+	auto start = pos + 2;
+	if (!IsAlnum(*start) && *start != '_') {
+		return nullptr;
+	}
+	auto label_end = start + 1;
+	while (label_end < end && (IsAlnum(*label_end) || *label_end == '_' || *label_end == '-')) {
+		label_end++;
+	}
+	data = start;
+	len = (idx_t)(label_end - start);
+	return label_end;
+}
+
+// Reads "string" with an optional @lang or ^^<datatype> at pos
+const char *NTriplesTokenizer::ReadLiteral(const char *pos, const char *end, NTriplesStatement &stmt) const {
+	auto start = pos + 1;
+	auto close = ScanString(start, end);
+	if (!close) {
+		return nullptr;
+	}
+	stmt.data[3] = start;
+	stmt.len[3] = (idx_t)(close - start);
+	stmt.literal = true;
+	pos = close + 1;
+	if (pos == end) {
+		return pos;
+	}
+	if (*pos == '@') {
+		auto lang = pos + 1;
+		pos = lang;
+		while (pos < end && IsAlpha(*pos)) {
+			pos++;
+		}
+		if (pos == lang) {
+			return nullptr;
+		}
+		while (pos < end && *pos == '-') {
+			auto subtag = ++pos;
+			while (pos < end && IsAlnum(*pos)) {
+				pos++;
+			}
+			if (pos == subtag) {
+				return nullptr;
+			}
+		}
+		stmt.data[5] = lang;
+		stmt.len[5] = (idx_t)(pos - lang);
+		return pos;
+	}
+	if (*pos == '^') {
+		if (end - pos < 3 || pos[1] != '^' || pos[2] != '<') {
+			return nullptr;
+		}
+		stmt.iri[4] = true;
+		return ReadIRI(pos + 2, end, stmt.data[4], stmt.len[4]);
+	}
+	return pos;
+}
+
+NTriplesTokenizer::Result NTriplesTokenizer::Tokenize(const char *pos, const char *end, NTriplesStatement &stmt) const {
+	pos = SkipSpace(pos, end);
+	if (pos == end || *pos == '#') {
+		return Result::EMPTY;
+	}
+	for (idx_t col = 0; col < 6; col++) {
+		stmt.data[col] = nullptr;
+		stmt.len[col] = 0;
+		stmt.iri[col] = false;
+	}
+	stmt.literal = false;
+
+	// Every term must be followed by whitespace, which keeps a '.' after a blank node label unambiguous
+	stmt.iri[1] = *pos == '<';
+	if (*pos == '<') {
+		pos = ReadIRI(pos, end, stmt.data[1], stmt.len[1]);
+	} else if (*pos == '_') {
+		pos = ReadBlank(pos, end, stmt.data[1], stmt.len[1]);
+	} else {
+		return Result::FALLBACK;
+	}
+	if (!pos || pos == end || !IsSpace(*pos)) {
+		return Result::FALLBACK;
+	}
+	pos = SkipSpace(pos, end);
+
+	if (pos == end || *pos != '<') {
+		return Result::FALLBACK;
+	}
+	stmt.iri[2] = true;
+	pos = ReadIRI(pos, end, stmt.data[2], stmt.len[2]);
+	if (!pos || pos == end || !IsSpace(*pos)) {
+		return Result::FALLBACK;
+	}
+	pos = SkipSpace(pos, end);
+
+	if (pos == end) {
+		return Result::FALLBACK;
+	}
+	stmt.iri[3] = *pos == '<';
+	if (*pos == '<') {
+		pos = ReadIRI(pos, end, stmt.data[3], stmt.len[3]);
+	} else if (*pos == '_') {
+		pos = ReadBlank(pos, end, stmt.data[3], stmt.len[3]);
+	} else if (*pos == '"') {
+		pos = ReadLiteral(pos, end, stmt);
+	} else {
+		return Result::FALLBACK;
+	}
+	if (!pos || pos == end || !IsSpace(*pos)) {
+		return Result::FALLBACK;
+	}
+	pos = SkipSpace(pos, end);
+
+	if (_quads && pos < end && (*pos == '<' || *pos == '_')) {
+		stmt.iri[0] = *pos == '<';
+		pos = *pos == '<' ? ReadIRI(pos, end, stmt.data[0], stmt.len[0])
+		                  : ReadBlank(pos, end, stmt.data[0], stmt.len[0]);
+		if (!pos || pos == end || !IsSpace(*pos)) {
+			return Result::FALLBACK;
+		}
+		pos = SkipSpace(pos, end);
+	}
+
+	if (pos == end || *pos != '.') {
+		return Result::FALLBACK;
+	}
+	pos = SkipSpace(pos + 1, end);
+	if (pos != end && *pos != '#') {
+		return Result::FALLBACK;
+	}
+	return Result::STATEMENT;
+}
@@ -0,0 +1,287 @@
+#include "include/parse_cache.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+using namespace duckdb;
+
+static const char CACHE_MAGIC[] = "RDFCACH1";
+static const char CACHE_END_MAGIC[] = "RDFCEND1";
+static constexpr idx_t MAGIC_SIZE = 8;
+// Footer offset and end magic
+static constexpr idx_t TRAILER_SIZE = sizeof(uint64_t) + MAGIC_SIZE;
+// Row count and column offsets
+static constexpr idx_t GROUP_HEADER_SIZE = (1 + CacheRowGroup::COLUMN_COUNT) * sizeof(uint64_t);
+
+template <class T>
+static void AppendValue(std::string &out, T value) {
+	out.append((const char *)&value, sizeof(T));
+}
+
+// Reads values from a buffer read from a cache file, checking they lie within it
+class CacheReader {
+public:
+	CacheReader(const char *data, idx_t size) : _data(data), _size(size) {
+	}
+
+	template <class T>
+	T Read() {
+		T value;
+		memcpy(&value, Take(sizeof(T)), sizeof(T));
+		return value;
+	}
+	const char *Take(idx_t len) {
+		if (len > _size - _pos) {
+			throw std::runtime_error("Corrupt parse cache file");
+		}
+		auto result = _data + _pos;
+		_pos += len;
+		return result;
+	}
+
+private:
+	const char *_data;
+	idx_t _size;
+	idx_t _pos = 0;
+};
+
+static std::vector<char> ReadAt(FileHandle &handle, idx_t offset, idx_t len) {
+	std::vector<char> buffer(len);
+	if (len > 0) {
+		handle.Read(buffer.data(), len, offset);
+	}
+	return buffer;
+}
+
+static std::string SerializeKey(const ParseCacheKey &key) {
+	std::string header(CACHE_MAGIC, MAGIC_SIZE);
+	AppendValue<uint64_t>(header, key.size);
+	AppendValue<int64_t>(header, key.last_modified);
+	AppendValue<uint8_t>(header, key.file_type);
+	AppendValue<uint8_t>(header, key.strict_parsing ? 1 : 0);
+	AppendValue<uint8_t>(header, key.expand_prefixes ? 1 : 0);
+	AppendValue<uint32_t>(header, (uint32_t)key.path.size());
+	header += key.path;
+	AppendValue<uint32_t>(header, (uint32_t)key.compaction.size());
+	header += key.compaction;
+	return header;
+}
+
+ParseCacheKey ParseCacheKey::Create(FileSystem &fs, const std::string &path, uint8_t file_type, bool strict_parsing,
+                                    bool expand_prefixes, const std::string &compaction) {
+	ParseCacheKey key;
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	key.path = path;
+	key.size = (idx_t)MaxValue<int64_t>(fs.GetFileSize(*handle), 0);
+	key.last_modified = fs.GetLastModifiedTime(*handle).value;
+	key.file_type = file_type;
+	key.strict_parsing = strict_parsing;
+	key.expand_prefixes = expand_prefixes;
+	key.compaction = compaction;
+	return key;
+}
+
+std::string ParseCachePath(FileSystem &fs, const std::string &cache_dir, const std::string &source_path) {
+	// Files with the same name in different directories get different caches
+	auto hash = (unsigned long long)Hash(source_path.c_str(), source_path.size());
+	return fs.JoinPath(cache_dir, FileSystem::ExtractName(source_path) + "." +
+	                                  StringUtil::Format("%016llx", hash) + ".rdfcache");
+}
+
+void CacheRowGroupBuilder::Append(DataChunk &chunk) {
+	auto count = chunk.size();
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		UnifiedVectorFormat format;
+		chunk.data[col].ToUnifiedFormat(count, format);
+		auto strings = UnifiedVectorFormat::GetData<string_t>(format);
+		auto &ids = _ids[col];
+		auto &terms = _terms[col];
+		auto &indices = _indices[col];
+		for (idx_t row = 0; row < count; row++) {
+			auto idx = format.sel->get_index(row);
+			if (!format.validity.RowIsValid(idx)) {
+				indices.push_back(0);
+				continue;
+			}
+			auto entry = ids.find(strings[idx]);
+			if (entry != ids.end()) {
+				indices.push_back(entry->second);
+				continue;
+			}
+			auto id = (uint32_t)terms.size() + 1;
+			auto term = _heap.AddBlob(strings[idx].GetData(), strings[idx].GetSize());
+			ids[term] = id;
+			terms.push_back(term);
+			indices.push_back(id);
+		}
+	}
+	_count += count;
+}
+
+std::string CacheRowGroupBuilder::Serialize() {
+	std::string columns[CacheRowGroup::COLUMN_COUNT];
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		auto &out = columns[col];
+		AppendValue<uint32_t>(out, (uint32_t)_terms[col].size());
+		for (auto &term : _terms[col]) {
+			AppendValue<uint32_t>(out, (uint32_t)term.GetSize());
+			out.append(term.GetData(), term.GetSize());
+		}
+		out.append((const char *)_indices[col].data(), _indices[col].size() * sizeof(uint32_t));
+	}
+	std::string group;
+	AppendValue<uint64_t>(group, _count);
+	idx_t offset = GROUP_HEADER_SIZE;
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		AppendValue<uint64_t>(group, offset);
+		offset += columns[col].size();
+	}
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		group += columns[col];
+		_ids[col].clear();
+		_terms[col].clear();
+		_indices[col].clear();
+	}
+	_heap.Destroy();
+	_count = 0;
+	return group;
+}
+
+unique_ptr<ParseCacheFile> ParseCacheFile::Open(FileSystem &fs, const std::string &cache_path,
+                                                const ParseCacheKey &key) {
+	try {
+		if (!fs.FileExists(cache_path)) {
+			return nullptr;
+		}
+		auto result = unique_ptr<ParseCacheFile>(new ParseCacheFile());
+		result->_handle = fs.OpenFile(cache_path, FileFlags::FILE_FLAGS_READ);
+		auto &handle = *result->_handle;
+		auto file_size = (idx_t)MaxValue<int64_t>(fs.GetFileSize(handle), 0);
+		auto expected = SerializeKey(key);
+		if (file_size < expected.size() + sizeof(uint64_t) + TRAILER_SIZE) {
+			return nullptr;
+		}
+		auto header = ReadAt(handle, 0, expected.size());
+		if (memcmp(header.data(), expected.data(), expected.size()) != 0) {
+			return nullptr; // a cache of another version of the file, or parsed with other options
+		}
+		auto trailer = ReadAt(handle, file_size - TRAILER_SIZE, TRAILER_SIZE);
+		CacheReader trailer_reader(trailer.data(), trailer.size());
+		auto footer_start = trailer_reader.Read<uint64_t>();
+		if (memcmp(trailer_reader.Take(MAGIC_SIZE), CACHE_END_MAGIC, MAGIC_SIZE) != 0 ||
+		    footer_start < expected.size() || footer_start > file_size - TRAILER_SIZE) {
+			return nullptr;
+		}
+		auto footer = ReadAt(handle, footer_start, file_size - TRAILER_SIZE - footer_start);
+		CacheReader footer_reader(footer.data(), footer.size());
+		auto group_count = footer_reader.Read<uint64_t>();
+		if (footer.size() != (group_count + 1) * sizeof(uint64_t)) {
+			return nullptr;
+		}
+		idx_t previous = expected.size();
+		for (idx_t i = 0; i < group_count; i++) {
+			auto offset = footer_reader.Read<uint64_t>();
+			if (offset < previous || offset + GROUP_HEADER_SIZE > footer_start) {
+				return nullptr;
+			}
+			result->_group_offsets.push_back(offset);
+			previous = offset + GROUP_HEADER_SIZE;
+		}
+		result->_group_offsets.push_back(footer_start);
+		return result;
+	} catch (std::exception &) {
+		// An unreadable cache is rebuilt
+		return nullptr;
+	}
+}
+
+unique_ptr<CacheRowGroup> ParseCacheFile::ReadGroup(idx_t group, const bool *columns) {
+	auto result = make_uniq<CacheRowGroup>();
+	idx_t start = _group_offsets[group];
+	idx_t size = GroupSize(group);
+	auto header = ReadAt(*_handle, start, GROUP_HEADER_SIZE);
+	CacheReader header_reader(header.data(), header.size());
+	result->count = header_reader.Read<uint64_t>();
+	idx_t offsets[CacheRowGroup::COLUMN_COUNT + 1];
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		offsets[col] = header_reader.Read<uint64_t>();
+	}
+	offsets[CacheRowGroup::COLUMN_COUNT] = size;
+
+	for (idx_t col = 0; col < CacheRowGroup::COLUMN_COUNT; col++) {
+		if (!columns[col]) {
+			continue;
+		}
+		if (offsets[col] > offsets[col + 1] || offsets[col + 1] > size) {
+			throw std::runtime_error("Corrupt parse cache file");
+		}
+		auto block = ReadAt(*_handle, start + offsets[col], offsets[col + 1] - offsets[col]);
+		CacheReader reader(block.data(), block.size());
+		auto term_count = reader.Read<uint32_t>();
+		auto terms = make_uniq<Vector>(LogicalType::VARCHAR, (idx_t)term_count + 1);
+		auto strings = FlatVector::GetData<string_t>(*terms);
+		FlatVector::SetNull(*terms, 0, true);
+		for (idx_t i = 1; i <= term_count; i++) {
+			auto len = reader.Read<uint32_t>();
+			strings[i] = StringVector::AddStringOrBlob(*terms, reader.Take(len), len);
+		}
+		auto &indices = result->indices[col];
+		indices.resize(result->count);
+		memcpy(indices.data(), reader.Take(result->count * sizeof(uint32_t)), result->count * sizeof(uint32_t));
+		for (auto index : indices) {
+			if (index > term_count) {
+				throw std::runtime_error("Corrupt parse cache file");
+			}
+		}
+		result->terms[col] = std::move(terms);
+		result->term_count[col] = (idx_t)term_count + 1;
+	}
+	return result;
+}
+
+ParseCacheWriter::ParseCacheWriter(FileSystem &fs, const std::string &cache_path, const ParseCacheKey &key)
+    : _fs(fs), _cache_path(cache_path) {
+	std::random_device random;
+	_temp_path = cache_path + StringUtil::Format(".%08x.tmp", (unsigned)random());
+	_handle = fs.OpenFile(_temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	Write(SerializeKey(key));
+}
+
+ParseCacheWriter::~ParseCacheWriter() {
+	if (_finished) {
+		return;
+	}
+	try {
+		_handle.reset();
+		_fs.RemoveFile(_temp_path);
+	} catch (std::exception &) {
+	}
+}
+
+void ParseCacheWriter::Write(const std::string &data) {
+	_handle->Write((void *)data.data(), data.size(), _position);
+	_position += data.size();
+}
+
+void ParseCacheWriter::WriteGroup(const std::string &group) {
+	_group_offsets.push_back(_position);
+	Write(group);
+}
+
+void ParseCacheWriter::Finish() {
+	std::string footer;
+	auto footer_start = _position;
+	AppendValue<uint64_t>(footer, _group_offsets.size());
+	for (auto offset : _group_offsets) {
+		AppendValue<uint64_t>(footer, offset);
+	}
+	AppendValue<uint64_t>(footer, footer_start);
+	footer.append(CACHE_END_MAGIC, MAGIC_SIZE);
+	Write(footer);
+	_handle->Sync();
+	_handle->Close();
+	_handle.reset();
+	_fs.MoveFile(_temp_path, _cache_path);
+	_finished = true;
+}
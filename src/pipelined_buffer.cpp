@@ -0,0 +1,91 @@
+#include "include/pipelined_buffer.hpp"
+
+using namespace duckdb;
+
+constexpr idx_t PipelinedBuffer::RING_SIZE;
+
+PipelinedBuffer::PipelinedBuffer(std::string path, std::unique_ptr<ITriplesBuffer> inner)
+    : ITriplesBuffer(std::move(path), ""), _inner(std::move(inner)) {
+}
+
+PipelinedBuffer::~PipelinedBuffer() {
+	{
+		std::lock_guard<std::mutex> lk(_lock);
+		_stop = true;
+	}
+	_free_cv.notify_all();
+	// The parser thread stops once the chunk it is parsing is done
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void PipelinedBuffer::StartParse() {
+	// The inner buffer was started before it was wrapped
+}
+
+void PipelinedBuffer::Prefetch() {
+	_inner->Prefetch();
+}
+
+void PipelinedBuffer::PopulateChunk(DataChunk &output) {
+	std::unique_lock<std::mutex> lk(_lock);
+	if (!_thread.joinable() && !_done) {
+		// The layout of the chunks is only known once the scan asks for the first one
+		_types = output.GetTypes();
+		_thread = std::thread([this] { Run(); });
+	}
+	_ready_cv.wait(lk, [&] { return !_ready.empty() || _done; });
+	if (_ready.empty()) {
+		if (_error) {
+			auto error = _error;
+			_error = nullptr;
+			std::rethrow_exception(error);
+		}
+		output.SetCardinality(0);
+		return;
+	}
+	auto chunk = std::move(_ready.front());
+	_ready.pop_front();
+	lk.unlock();
+	_free_cv.notify_one();
+	// The output shares the chunk's buffers, which live on after the chunk
+	output.Reference(*chunk);
+}
+
+void PipelinedBuffer::Run() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lk(_lock);
+			_free_cv.wait(lk, [&] { return _ready.size() < RING_SIZE || _stop; });
+			if (_stop) {
+				return;
+			}
+		}
+		auto chunk = make_uniq<DataChunk>();
+		try {
+			chunk->Initialize(ChunkAllocator(), _types);
+			_inner->PopulateChunk(*chunk);
+		} catch (...) {
+			std::lock_guard<std::mutex> lk(_lock);
+			_error = std::current_exception();
+			_done = true;
+			_ready_cv.notify_one();
+			return;
+		}
+		_bytes_read = _inner->BytesRead();
+		bool end = chunk->size() == 0;
+		{
+			std::lock_guard<std::mutex> lk(_lock);
+			if (end) {
+				_done = true;
+			} else {
+				_ready.push_back(std::move(chunk));
+			}
+		}
+		_ready_cv.notify_one();
+		if (end) {
+			return;
+		}
+	}
+}
@@ -3,16 +3,27 @@
 #include "rdf_extension.hpp"
 #include "duckdb.hpp"
 #include "include/serd_buffer.hpp"
+#include "include/speculative_turtle.hpp"
+#include "include/line_range_reader.hpp"
 #include "include/xml_buffer.hpp"
+#include "include/hdt_buffer.hpp"
 #include "include/I_triples_buffer.hpp"
+#include "include/cache_buffer.hpp"
+#include "include/pipelined_buffer.hpp"
+#include "include/zone_index.hpp"
+#include "include/term_ids.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/parser/parsed_data/copy_info.hpp"
 #include "duckdb/main/connection.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/parser/parsed_data/sample_options.hpp"
 #include <duckdb/parser/parsed_data/create_table_function_info.hpp>
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/storage/statistics/node_statistics.hpp"
+#include "duckdb/storage/statistics/string_stats.hpp"
 #include <r2rml/R2RMLMapping.h>
 #include <r2rml/R2RMLParser.h>
 #include <r2rml/MapSQLRow.h>
@@ -22,15 +33,34 @@
 #include <r2rml/SQLValue.h>
 #include <r2rml/StringSQLValue.h>
 #include <r2rml/TriplesMap.h>
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <random>
 #include <unordered_map>
 
 using namespace std;
 
-#define STRICT_PARSING   "strict_parsing"
-#define PREFIX_EXPANSION "prefix_expansion"
-#define FILE_TYPE        "file_type"
+#define STRICT_PARSING    "strict_parsing"
+#define PREFIX_EXPANSION  "prefix_expansion"
+#define FILE_TYPE         "file_type"
+#define SPECULATIVE       "speculative_parsing"
+#define TYPED_OBJECTS     "typed_objects"
+#define BUFFER_SIZE       "buffer_size"
+#define MEMORY_MAP        "memory_map"
+#define CACHE_DIR         "cache_dir"
+#define ENCODE_TERMS      "encode_terms"
+#define COMPACT_IRIS      "compact_iris"
+#define PREFIXES          "prefixes"
+#define FILENAME          "filename"
+#define HIVE_PARTITIONING "hive_partitioning"
+#define PIPELINED_PARSING "pipelined_parsing"
+#define SAMPLE_FRACTION   "sample_fraction"
+#define BLOCK_SIZE        "block_size"
+#define START_OFFSETS     "start_offsets"
+#define END_OFFSET        "end_offset"
+#define FRAME_RANGE_SIZE  "frame_range_size"
 
 namespace duckdb {
 
@@ -74,6 +104,8 @@ static ITriplesBuffer::FileType ConvertLabelToFileType(const std::string &s) {
 		return ITriplesBuffer::TRIG;
 	if (x == "rdf" || x == "xml")
 		return ITriplesBuffer::XML;
+	if (x == "hdt")
+		return ITriplesBuffer::HDT;
 	return ITriplesBuffer::UNKNOWN;
 }
 
@@ -91,10 +123,13 @@ static SerdSyntax ParseRdfFormat(const std::string &fmt) {
 }
 
 static ITriplesBuffer::FileType DetectFileTypeFromPath(const std::string &path) {
-	auto pos = path.rfind('.');
+	// data.nt.gz is NTriples
+	std::string stem;
+	CompressionFromPath(path, stem);
+	auto pos = stem.rfind('.');
 	if (pos == std::string::npos)
 		return ITriplesBuffer::UNKNOWN;
-	std::string ext = path.substr(pos + 1);
+	std::string ext = stem.substr(pos + 1);
 	return ConvertLabelToFileType(ext);
 }
 
@@ -112,16 +147,315 @@ struct RDFReaderBindData : public TableFunctionData {
 	ITriplesBuffer::FileType file_type = ITriplesBuffer::UNKNOWN;
 	bool strict_parsing = true;
 	bool expand_prefixes = false;
+	// Split large Turtle/TriG files at guessed statement boundaries
+	bool speculative_parsing = false;
+	// Parse files that are read whole on a thread of their own, ahead of the scan
+	bool pipelined_parsing = false;
+	// Fraction of the statements to return, see RDFReaderGlobalState::sample_fraction
+	double sample_fraction = 1.0;
+	// Add the typed object columns
+	bool typed_objects = false;
+	// Bytes read at a time ahead of the parsers
+	idx_t buffer_size = ReadAheadBuffer::DEFAULT_BUFFER_SIZE;
+	// Compressed bytes of whole frames per task of a BGZF or seekable zstd file; files no larger are
+	// decompressed by one thread. Set in bind to RDFReaderGlobalState::COMPRESSED_RANGE_SIZE by default.
+	idx_t frame_range_size = 0;
+	// Map local NTriples/NQuads files into memory instead of reading them. Off by default: a mapped
+	// file truncated or rewritten while its terms are referenced makes the process crash (SIGBUS).
+	bool memory_map = false;
+	// Directory of the parse caches; empty when files are always parsed
+	string cache_dir;
+	// Return graph, subject, predicate and object as ids from the database's RDFTermIds
+	bool encode_terms = false;
+	// Rewrite IRIs as CURIEs, with the prefixes below and those the files declare
+	bool compact_iris = false;
+	vector<pair<string, string>> prefixes;
+	// Add a filename column, and a column per hive partition key (key=value directories) of the
+	// paths. These file columns follow the others, from file_columns_start on.
+	bool filename = false;
+	vector<string> hive_keys;
+	idx_t file_columns_start = 0;
+	// Add an end_offset column, after filename. With it or start_offsets, uncompressed NTriples and
+	// NQuads files are read from their start offset up to the end of their last complete line when
+	// the scan starts, the end offset (see RDFReaderGlobalState::end_offsets). Per file; empty
+	// without either option.
+	bool end_offset = false;
+	vector<idx_t> start_offsets;
+	// Statements the scan is expected to return, estimated from the file sizes
+	idx_t estimated_statements = 0;
+	// Every file is in a format whose parser never returns a NULL subject, predicate or object
+	bool terms_not_null = false;
+	// Some file may have named graphs
+	bool has_graphs = true;
 };
 
-// Global state: shared across all threads, tracks which file to process next
+static idx_t FileColumnCount(const RDFReaderBindData &bind_data) {
+	return (bind_data.filename ? 1 : 0) + (bind_data.end_offset ? 1 : 0) + bind_data.hive_keys.size();
+}
+
+static bool IsFileColumn(const RDFReaderBindData &bind_data, column_t col) {
+	return col >= bind_data.file_columns_start && col < bind_data.file_columns_start + FileColumnCount(bind_data);
+}
+
+// The key=value directories of a path, outermost first
+static vector<pair<string, string>> HivePartitions(const string &path) {
+	vector<pair<string, string>> partitions;
+	idx_t start = 0;
+	for (idx_t i = 0; i < path.size(); i++) {
+		if (path[i] != '/' && path[i] != '\\') {
+			continue;
+		}
+		auto eq = path.find('=', start);
+		if (eq != string::npos && eq > start && eq < i) {
+			partitions.emplace_back(path.substr(start, eq - start), path.substr(eq + 1, i - eq - 1));
+		}
+		start = i + 1;
+	}
+	return partitions;
+}
+
+// The value of a file column for a file: its path, its end offset, or the value of a partition key
+// (NULL when the path has no such key, or the file has no end offset)
+static Value FileColumnValue(const RDFReaderBindData &bind_data, idx_t file_idx, column_t col, idx_t end_offset) {
+	auto &path = bind_data.file_paths[file_idx];
+	idx_t k = col - bind_data.file_columns_start;
+	if (bind_data.filename) {
+		if (k == 0) {
+			return Value(path);
+		}
+		k--;
+	}
+	if (bind_data.end_offset) {
+		if (k == 0) {
+			if (end_offset == DConstants::INVALID_INDEX) {
+				return Value(LogicalType::BIGINT);
+			}
+			return Value::BIGINT((int64_t)end_offset);
+		}
+		k--;
+	}
+	for (auto &partition : HivePartitions(path)) {
+		if (partition.first == bind_data.hive_keys[k]) {
+			// Spark and Hive write NULL partition values as this
+			if (partition.second == "__HIVE_DEFAULT_PARTITION__") {
+				break;
+			}
+			return Value(partition.second);
+		}
+	}
+	return Value(LogicalType::VARCHAR);
+}
+
+// Bytes sampled from the first file to estimate the size of its statements
+static constexpr idx_t ESTIMATE_SAMPLE_SIZE = 64 * 1024;
+// Files whose size is looked up at bind time; the size of the others is extrapolated from them
+static constexpr idx_t ESTIMATE_MAX_FILES = 64;
+// Compressed files are assumed to hold this many times their size in RDF text
+static constexpr idx_t ESTIMATE_COMPRESSION_RATIO = 4;
+// Bytes per statement assumed when the sample holds no complete statement
+static constexpr idx_t ESTIMATE_STATEMENT_SIZE = 100;
+
+// Rough count of the statements in the complete lines of a sample: the lines of NTriples/NQuads,
+// the lines of Turtle/TriG ending in '.', ';' or ',', the start tags of RDF/XML
+static idx_t CountSampleStatements(const char *data, idx_t len, ITriplesBuffer::FileType ft) {
+	idx_t count = 0;
+	if (ft == ITriplesBuffer::XML) {
+		for (idx_t i = 0; i + 1 < len; i++) {
+			if (data[i] == '<' && data[i + 1] != '/' && data[i + 1] != '?' && data[i + 1] != '!') {
+				count++;
+			}
+		}
+		return count;
+	}
+	idx_t line_start = 0;
+	for (idx_t i = 0; i < len; i++) {
+		if (data[i] != '\n') {
+			continue;
+		}
+		idx_t first = line_start;
+		while (first < i && (data[first] == ' ' || data[first] == '\t')) {
+			first++;
+		}
+		idx_t last = i;
+		while (last > first && (data[last - 1] == ' ' || data[last - 1] == '\t' || data[last - 1] == '\r')) {
+			last--;
+		}
+		line_start = i + 1;
+		if (first == last || data[first] == '#') {
+			continue;
+		}
+		if (ft == ITriplesBuffer::NTRIPLES || ft == ITriplesBuffer::NQUADS) {
+			count++;
+		} else if (data[first] != '@' && (data[last - 1] == '.' || data[last - 1] == ';' || data[last - 1] == ',')) {
+			count++;
+		}
+	}
+	return count;
+}
+
+// Estimates the statements in the files of a scan from their size and the bytes per statement of
+// a sample from the first file. INVALID_INDEX if a file is a pipe, whose size is unknown.
+static idx_t EstimateStatements(FileSystem &fs, const RDFReaderBindData &bind_data) {
+	auto &paths = bind_data.file_paths;
+	idx_t sized_files = MinValue<idx_t>(paths.size(), ESTIMATE_MAX_FILES);
+	double total_size = 0;
+	double first_size = 0;
+	for (idx_t i = 0; i < sized_files; i++) {
+		if (IsPipeInput(fs, paths[i])) {
+			// Sampling would take bytes the scan can't read again
+			return DConstants::INVALID_INDEX;
+		}
+		try {
+			auto handle = fs.OpenFile(paths[i], FileFlags::FILE_FLAGS_READ);
+			int64_t sz = fs.GetFileSize(*handle);
+			string stem;
+			auto ratio = CompressionFromPath(paths[i], stem) == RDFCompression::NONE ? 1 : ESTIMATE_COMPRESSION_RATIO;
+			double size = (double)MaxValue<int64_t>(sz, 0) * (double)ratio;
+			first_size = i == 0 ? size : first_size;
+			total_size += size;
+		} catch (std::exception &) {
+		}
+	}
+	total_size = total_size * (double)paths.size() / (double)sized_files;
+
+	double statement_size = ESTIMATE_STATEMENT_SIZE;
+	auto ft = bind_data.file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(paths[0]) : bind_data.file_type;
+	if (ft == ITriplesBuffer::HDT) {
+		// HDT files state their triple count in their header
+		try {
+			auto triples = HDTFile::ReadTripleCount(fs, paths[0]);
+			if (triples > 0 && first_size > 0) {
+				statement_size = first_size / (double)triples;
+			}
+		} catch (std::exception &) {
+		}
+		return (idx_t)(total_size / statement_size + 0.5);
+	}
+	if (ft == ITriplesBuffer::NTRIPLES || ft == ITriplesBuffer::NQUADS) {
+		// So do files with a zone index
+		auto index = ZoneIndex::Open(fs, paths[0], ft == ITriplesBuffer::NQUADS);
+		if (index && index->StatementCount() > 0) {
+			statement_size = (double)index->blocks.back().end / (double)index->StatementCount();
+			return (idx_t)(total_size / statement_size + 0.5);
+		}
+	}
+	try {
+		RDFCompression compression;
+		auto handle = OpenRDFInput(fs, paths[0], compression);
+		RDFInputReader reader(*handle, compression);
+		vector<char> sample(ESTIMATE_SAMPLE_SIZE);
+		idx_t len = 0;
+		while (len < sample.size()) {
+			idx_t read = reader.Read(sample.data() + len, sample.size() - len);
+			if (read == 0) {
+				break;
+			}
+			len += read;
+		}
+		// Only complete lines are counted, and measured
+		while (len > 0 && sample[len - 1] != '\n' && ft != ITriplesBuffer::XML) {
+			len--;
+		}
+		idx_t count = CountSampleStatements(sample.data(), len, ft);
+		if (count > 0) {
+			statement_size = (double)len / (double)count;
+		}
+	} catch (std::exception &) {
+	}
+	return (idx_t)(total_size / statement_size + 0.5);
+}
+
+// A unit of scan work: a whole file, a newline-aligned byte range of a line-oriented file,
+// or a batch of small files
+struct RDFScanTask {
+	idx_t file_idx = 0;
+	idx_t range_start = 0;
+	// INVALID_INDEX: parse the whole file
+	idx_t range_end = DConstants::INVALID_INDEX;
+	// Chunk of a speculatively split Turtle/TriG file, see speculative_turtle.hpp
+	idx_t chunk_idx = DConstants::INVALID_INDEX;
+	idx_t skip_statements = 0;
+	// Small files parsed whole, one after the other, after file_idx
+	vector<idx_t> batch;
+	// The range is a run of frames of a compressed file, which can't be split further
+	bool frames = false;
+	// The range is a run of row groups of the file's parse cache
+	bool cached = false;
+	// The range was drawn for a sample, so all its statements are returned
+	bool sampled = false;
+	// The range is a run of triples of this HDT file
+	std::shared_ptr<HDTFile> hdt;
+	// Size of the file(s) the task belongs to; tasks of larger files are handed out first
+	idx_t size = 0;
+};
+
+// A byte range being parsed, whose unread tail an idle thread may take over
+struct RDFActiveRange {
+	idx_t file_idx;
+	std::shared_ptr<LineRangeClaim> claim;
+};
+
+// Global state: shared across all threads, hands out scan tasks
 struct RDFReaderGlobalState : public GlobalTableFunctionState {
-	std::mutex lock;
-	idx_t next_file = 0;
-	idx_t file_count = 0;
+	// NTriples/NQuads files larger than this are split into ranges parsed concurrently
+	static constexpr idx_t SCAN_RANGE_SIZE = 8 * 1024 * 1024;
+	// Files smaller than this are batched together, up to SCAN_RANGE_SIZE bytes per batch
+	static constexpr idx_t SMALL_FILE_SIZE = 1024 * 1024;
+	// An idle thread only splits a range with at least twice this much left to read
+	static constexpr idx_t STEAL_MIN_SIZE = 1024 * 1024;
+	// Compressed files decompress to several times their size, so their frames are handed out in
+	// smaller ranges; the default of frame_range_size
+	static constexpr idx_t COMPRESSED_RANGE_SIZE = 2 * 1024 * 1024;
+	// Triples per task of an HDT file
+	static constexpr idx_t HDT_RANGE_TRIPLES = 1024 * 1024;
+	// Large line-format files are sampled in ranges of this size
+	static constexpr idx_t SAMPLE_RANGE_SIZE = 1024 * 1024;
+	// Batch indices per task of an ordered scan, and per thread of an unordered one; the chunks past
+	// this share the last index
+	static constexpr idx_t TASK_BATCHES = 1024 * 1024;
 
+	std::mutex lock;
+	vector<RDFScanTask> tasks;
+	idx_t next_task = 0;
+	vector<RDFActiveRange> active_ranges;
+	idx_t max_threads = 1;
+	// Set when DuckDB preserves insertion order: tasks are claimed in file order and never split
+	// again, so each chunk can be numbered by its task and its place in it (see RDFReaderGetPartitionData)
+	bool ordered = false;
+	// Fraction of the statements to return: sample_fraction times a pushed down SYSTEM sample. Ranges
+	// of large line-format files, frames of compressed ones and row groups of parse caches are kept or
+	// skipped whole; the statements of everything else one by one, before their terms are written.
+	double sample_fraction = 1.0;
+	uint64_t sample_seed = 0;
+	std::mt19937_64 sample_rng;
+	// Draws whether a range belongs to the sample
+	bool SampleRange() {
+		return std::uniform_real_distribution<double>(0.0, 1.0)(sample_rng) < sample_fraction;
+	}
+	// Turtle/TriG files split at guessed statement boundaries, by file index
+	unordered_map<idx_t, unique_ptr<SpeculativeTurtleFile>> speculative_files;
+	// Staged rows of speculative chunks whose start has been confirmed, waiting to be returned
+	vector<unique_ptr<ColumnDataCollection>> ready_rows;
+	// Progress: the size of the input (compressed files scaled to their expected text size) and the
+	// bytes the parsers have taken from it so far
+	idx_t total_bytes = 0;
+	std::atomic<idx_t> bytes_read {0};
+	// Numbers the threads of the scan, for the batch indices of an unordered scan
+	std::atomic<idx_t> next_thread {0};
+	// Zone index blocks whose bounds pass the scan's filters, and those skipped; shown by EXPLAIN ANALYZE
+	idx_t index_blocks_scanned = 0;
+	idx_t index_blocks_pruned = 0;
+	// Set with encode_terms
+	shared_ptr<RDFTermIds> term_ids;
+	// With end_offset or start_offsets, the end offset of each file the scan reads (see
+	// RDFReaderBindData::end_offset); INVALID_INDEX for files read whole or not read
+	vector<idx_t> end_offsets;
+
+	idx_t EndOffset(idx_t file_idx) const {
+		return end_offsets.empty() ? DConstants::INVALID_INDEX : end_offsets[file_idx];
+	}
 	idx_t MaxThreads() const override {
-		return file_count;
+		return max_threads;
 	}
 };
 
@@ -129,8 +463,124 @@ struct RDFReaderGlobalState : public GlobalTableFunctionState {
 struct RDFReaderLocalState : public LocalTableFunctionState {
 	std::unique_ptr<ITriplesBuffer> ib;
 	vector<column_t> column_ids;
+	// Filters pushed into the parsers; each buffer compiles its own copy
+	optional_ptr<TableFilterSet> filters;
+	// The filters the parsers can't apply to bytes, applied to each chunk they return
+	unique_ptr<RDFChunkFilter> chunk_filter;
+	RDFScanTask task;
+	// Copied from the global state
+	double sample_fraction = 1.0;
+	uint64_t sample_seed = 0;
+	// Position of the task in the global task list, and the chunks returned from it so far
+	idx_t task_seq = 0;
+	idx_t chunk_seq = 0;
+	// In an unordered scan, the thread's number and the chunks it has returned so far
+	idx_t thread_seq = 0;
+	idx_t thread_chunks = 0;
+	// Next file of the task's batch
+	idx_t batch_pos = 0;
+	// Set while ib parses a chunk of a speculatively split file
+	SerdBuffer *chunk_ib = nullptr;
+	// The next file of the batch, already reading in the background
+	std::unique_ptr<ITriplesBuffer> prefetched;
+	idx_t prefetched_file = DConstants::INVALID_INDEX;
+	// Bytes of ib's input already added to the global progress
+	idx_t reported_bytes = 0;
+	// Staged rows this thread is returning
+	unique_ptr<ColumnDataCollection> ready_rows;
+	ColumnDataScanState ready_scan;
+	// With encode_terms, the parsers fill terms, which the encoder turns into the output
+	unique_ptr<RDFTermEncoder> encoder;
+	DataChunk terms;
+	// The file columns of the scan, by slot, and the file ib reads
+	vector<pair<idx_t, column_t>> file_columns;
+	idx_t ib_file = DConstants::INVALID_INDEX;
 };
 
+// Line-oriented formats can be split at any newline, so their files can be parsed by several threads
+static bool IsSplittableFileType(ITriplesBuffer::FileType ft) {
+	return ft == ITriplesBuffer::NTRIPLES || ft == ITriplesBuffer::NQUADS;
+}
+
+// Bytes read at a time while looking for the last newline of a file
+static constexpr idx_t LAST_LINE_READ_SIZE = 64 * 1024;
+
+// Only the lines of uncompressed NTriples and NQuads files can be resumed at a byte offset
+static bool IsResumableFile(FileSystem &fs, const RDFReaderBindData &bind_data, const string &path) {
+	auto ft = bind_data.file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(path) : bind_data.file_type;
+	return IsSplittableFileType(ft) && !IsPipeInput(fs, path) && DetectCompression(fs, path) == RDFCompression::NONE;
+}
+
+static void CheckStartOffset(idx_t start, const string &path, idx_t size) {
+	if (start > size) {
+		throw InvalidInputException("start_offsets: offset %llu is past the end of %s (%llu bytes)",
+		                            (unsigned long long)start, path, (unsigned long long)size);
+	}
+}
+
+// The offset after the last newline at or after start, or start if there is none: the end of the
+// complete lines a writer appending to the file has finished
+static idx_t LastLineEnd(FileSystem &fs, const string &path, idx_t start) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	auto size = (idx_t)MaxValue<int64_t>(fs.GetFileSize(*handle), 0);
+	CheckStartOffset(start, path, size);
+	vector<char> block(LAST_LINE_READ_SIZE);
+	idx_t end = size;
+	while (end > start) {
+		idx_t len = MinValue<idx_t>(end - start, LAST_LINE_READ_SIZE);
+		handle->Read(block.data(), len, end - len);
+		for (idx_t i = len; i > 0; i--) {
+			if (block[i - 1] == '\n') {
+				return end - len + i;
+			}
+		}
+		end -= len;
+	}
+	return start;
+}
+
+// Sets the start offsets of the files, checking those start_offsets names. The end offsets are
+// found when the scan starts, for the files it reads.
+static void BindOffsets(FileSystem &fs, RDFReaderBindData &bind_data, const Value &start_offsets) {
+	unordered_map<string, idx_t> starts;
+	if (!start_offsets.IsNull()) {
+		for (auto &entry : MapValue::GetChildren(start_offsets)) {
+			auto &kv = StructValue::GetChildren(entry);
+			auto offset = kv[1].IsNull() ? 0 : kv[1].GetValue<int64_t>();
+			if (offset < 0) {
+				throw InvalidInputException("start_offsets: the offset of '%s' is negative", kv[0].ToString());
+			}
+			starts[kv[0].GetValue<string>()] = (idx_t)offset;
+		}
+	}
+	for (auto &path : bind_data.file_paths) {
+		auto entry = starts.find(path);
+		if (entry == starts.end()) {
+			bind_data.start_offsets.push_back(0);
+			continue;
+		}
+		auto start = entry->second;
+		starts.erase(entry);
+		if (start > 0) {
+			if (!IsResumableFile(fs, bind_data, path)) {
+				throw InvalidInputException(
+				    "start_offsets only applies to uncompressed NTriples and NQuads files, not: " + path);
+			}
+			auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+			CheckStartOffset(start, path, (idx_t)MaxValue<int64_t>(fs.GetFileSize(*handle), 0));
+		}
+		bind_data.start_offsets.push_back(start);
+	}
+	if (!starts.empty()) {
+		vector<string> unmatched;
+		for (auto &entry : starts) {
+			unmatched.push_back("'" + entry.first + "'");
+		}
+		std::sort(unmatched.begin(), unmatched.end());
+		throw InvalidInputException("start_offsets: no file read matches %s", StringUtil::Join(unmatched, ", "));
+	}
+}
+
 static unique_ptr<FunctionData> RDFReaderBind(ClientContext &context, TableFunctionBindInput &input,
                                               vector<LogicalType> &return_types, vector<string> &names) {
 	auto result = make_uniq<RDFReaderBindData>();
@@ -161,6 +611,24 @@ static unique_ptr<FunctionData> RDFReaderBind(ClientContext &context, TableFunct
 		result->strict_parsing = true;
 	}
 
+	auto speculative_param = input.named_parameters.find(SPECULATIVE);
+	if (speculative_param != input.named_parameters.end()) {
+		result->speculative_parsing = speculative_param->second.GetValue<bool>();
+	}
+
+	auto pipelined_param = input.named_parameters.find(PIPELINED_PARSING);
+	if (pipelined_param != input.named_parameters.end()) {
+		result->pipelined_parsing = pipelined_param->second.GetValue<bool>();
+	}
+
+	auto sample_param = input.named_parameters.find(SAMPLE_FRACTION);
+	if (sample_param != input.named_parameters.end()) {
+		result->sample_fraction = sample_param->second.GetValue<double>();
+		if (!(result->sample_fraction > 0.0 && result->sample_fraction <= 1.0)) {
+			throw InvalidInputException("sample_fraction must be greater than 0 and at most 1");
+		}
+	}
+
 	auto prefix_expansion_param = input.named_parameters.find(PREFIX_EXPANSION);
 	if (prefix_expansion_param != input.named_parameters.end()) {
 		result->expand_prefixes = prefix_expansion_param->second.GetValue<bool>();
@@ -168,25 +636,615 @@ static unique_ptr<FunctionData> RDFReaderBind(ClientContext &context, TableFunct
 		result->expand_prefixes = false;
 	}
 
+	auto typed_objects_param = input.named_parameters.find(TYPED_OBJECTS);
+	if (typed_objects_param != input.named_parameters.end()) {
+		result->typed_objects = typed_objects_param->second.GetValue<bool>();
+	}
+
+	auto buffer_size_param = input.named_parameters.find(BUFFER_SIZE);
+	if (buffer_size_param != input.named_parameters.end()) {
+		auto buffer_size = buffer_size_param->second.GetValue<int64_t>();
+		if (buffer_size < (int64_t)ReadAheadBuffer::MIN_BUFFER_SIZE) {
+			throw InvalidInputException("buffer_size must be at least %llu bytes",
+			                            (unsigned long long)ReadAheadBuffer::MIN_BUFFER_SIZE);
+		}
+		result->buffer_size = (idx_t)buffer_size;
+	}
+
+	result->frame_range_size = RDFReaderGlobalState::COMPRESSED_RANGE_SIZE;
+	auto frame_range_size_param = input.named_parameters.find(FRAME_RANGE_SIZE);
+	if (frame_range_size_param != input.named_parameters.end()) {
+		auto frame_range_size = frame_range_size_param->second.GetValue<int64_t>();
+		if (frame_range_size <= 0) {
+			throw InvalidInputException("frame_range_size must be positive");
+		}
+		result->frame_range_size = (idx_t)frame_range_size;
+	}
+
+	auto memory_map_param = input.named_parameters.find(MEMORY_MAP);
+	if (memory_map_param != input.named_parameters.end()) {
+		result->memory_map = memory_map_param->second.GetValue<bool>();
+	}
+
+	auto cache_dir_param = input.named_parameters.find(CACHE_DIR);
+	if (cache_dir_param != input.named_parameters.end()) {
+		result->cache_dir = cache_dir_param->second.GetValue<string>();
+		if (!result->cache_dir.empty() && !fs.DirectoryExists(result->cache_dir)) {
+			fs.CreateDirectory(result->cache_dir);
+		}
+	}
+
+	auto encode_terms_param = input.named_parameters.find(ENCODE_TERMS);
+	if (encode_terms_param != input.named_parameters.end()) {
+		result->encode_terms = encode_terms_param->second.GetValue<bool>();
+	}
+
+	auto compact_iris_param = input.named_parameters.find(COMPACT_IRIS);
+	if (compact_iris_param != input.named_parameters.end()) {
+		result->compact_iris = compact_iris_param->second.GetValue<bool>();
+	}
+	auto prefixes_param = input.named_parameters.find(PREFIXES);
+	if (prefixes_param != input.named_parameters.end()) {
+		if (!result->compact_iris) {
+			throw InvalidInputException("prefixes can only be used with compact_iris");
+		}
+		if (!prefixes_param->second.IsNull()) {
+			for (auto &entry : MapValue::GetChildren(prefixes_param->second)) {
+				auto &kv = StructValue::GetChildren(entry);
+				if (kv[1].IsNull()) {
+					throw InvalidInputException("prefixes: the namespace of prefix '%s' is NULL", kv[0].ToString());
+				}
+				result->prefixes.emplace_back(kv[0].GetValue<string>(), kv[1].GetValue<string>());
+			}
+		}
+	}
+	if (result->compact_iris && result->expand_prefixes) {
+		throw InvalidInputException("compact_iris and prefix_expansion cannot be used together");
+	}
+
+	// What the formats of the files guarantee about the term columns
+	result->terms_not_null = true;
+	result->has_graphs = false;
+	for (auto &file_path : result->file_paths) {
+		auto ft = result->file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(file_path) : result->file_type;
+		// RDF/XML returns empty literals as NULL
+		if (ft != ITriplesBuffer::TURTLE && ft != ITriplesBuffer::NTRIPLES && ft != ITriplesBuffer::NQUADS &&
+		    ft != ITriplesBuffer::TRIG && ft != ITriplesBuffer::HDT) {
+			result->terms_not_null = false;
+		}
+		if (ft == ITriplesBuffer::NQUADS || ft == ITriplesBuffer::TRIG || ft == ITriplesBuffer::UNKNOWN) {
+			result->has_graphs = true;
+		}
+	}
+	result->estimated_statements = EstimateStatements(fs, *result);
+	if (result->estimated_statements != DConstants::INVALID_INDEX) {
+		result->estimated_statements = (idx_t)((double)result->estimated_statements * result->sample_fraction + 0.5);
+	}
+
 	names = {"graph", "subject", "predicate", "object", "object_datatype", "object_lang"};
 	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR,
 	                LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+	if (result->encode_terms) {
+		for (idx_t col = 0; col < 4; col++) {
+			return_types[col] = LogicalType::BIGINT;
+		}
+	}
+	if (result->typed_objects) {
+		TypedObjectBatch::AddColumns(return_types, names);
+	}
+
+	auto filename_param = input.named_parameters.find(FILENAME);
+	if (filename_param != input.named_parameters.end()) {
+		result->filename = filename_param->second.GetValue<bool>();
+	}
+	auto hive_param = input.named_parameters.find(HIVE_PARTITIONING);
+	if (hive_param != input.named_parameters.end() && hive_param->second.GetValue<bool>()) {
+		// Keys in the order they first appear; files without a key get NULL for it
+		for (auto &file_path : result->file_paths) {
+			for (auto &partition : HivePartitions(file_path)) {
+				auto &keys = result->hive_keys;
+				if (std::find(keys.begin(), keys.end(), partition.first) == keys.end()) {
+					keys.push_back(partition.first);
+				}
+			}
+		}
+	}
+	auto end_offset_param = input.named_parameters.find(END_OFFSET);
+	if (end_offset_param != input.named_parameters.end()) {
+		result->end_offset = end_offset_param->second.GetValue<bool>();
+	}
+	auto start_offsets_param = input.named_parameters.find(START_OFFSETS);
+	if (start_offsets_param != input.named_parameters.end() || result->end_offset) {
+		BindOffsets(fs, *result,
+		            start_offsets_param != input.named_parameters.end() ? start_offsets_param->second : Value());
+	}
+	result->file_columns_start = names.size();
+	if (result->filename) {
+		names.push_back("filename");
+		return_types.push_back(LogicalType::VARCHAR);
+	}
+	if (result->end_offset) {
+		names.push_back("end_offset");
+		return_types.push_back(LogicalType::BIGINT);
+	}
+	for (auto &key : result->hive_keys) {
+		if (std::find(names.begin(), names.end(), key) != names.end()) {
+			throw InvalidInputException("Hive partition key '%s' has the name of a column of read_rdf", key);
+		}
+		names.push_back(key);
+		return_types.push_back(LogicalType::VARCHAR);
+	}
 	return std::move(result);
 }
 
-// Creates the shared global state; called once before any threads start scanning
+struct RDFFileInfo {
+	idx_t size = 0;
+	bool can_seek = false;
+	RDFCompression compression = RDFCompression::NONE;
+};
+
+// Returns the size of a file and whether it can be read in byte ranges. A file that can't be
+// opened reports size 0; the buffer reports why when it is parsed.
+static RDFFileInfo ProbeFile(FileSystem &fs, const string &file_path) {
+	RDFFileInfo info;
+	if (IsPipeInput(fs, file_path)) {
+		// Left unopened: it is read once, front to back, by the buffer that parses it
+		string stem;
+		info.compression = CompressionFromPath(file_path, stem);
+		return info;
+	}
+	try {
+		auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+		int64_t sz = fs.GetFileSize(*handle);
+		info.size = sz > 0 ? (idx_t)sz : 0;
+		info.compression = DetectCompression(fs, file_path);
+		// Byte ranges of a compressed file are only meaningful at frame boundaries
+		info.can_seek = handle->CanSeek() && info.compression == RDFCompression::NONE;
+	} catch (std::exception &) {
+	}
+	return info;
+}
+
+static ParseCacheKey CreateCacheKey(FileSystem &fs, const RDFReaderBindData &bind_data, const string &file_path) {
+	auto ft = bind_data.file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(file_path) : bind_data.file_type;
+	// Caches of the file compacted with other prefixes do not match
+	string compaction;
+	if (bind_data.compact_iris) {
+		compaction = "compact_iris";
+		for (auto &prefix : bind_data.prefixes) {
+			compaction += '\0' + prefix.first + '\0' + prefix.second;
+		}
+	}
+	return ParseCacheKey::Create(fs, file_path, (uint8_t)ft, bind_data.strict_parsing, bind_data.expand_prefixes,
+	                             compaction);
+}
+
+// Reads a file from its parse cache, a row group per task.
+// Returns false if the file has no up to date cache.
+static bool AddCacheTasks(FileSystem &fs, const RDFReaderBindData &bind_data, idx_t file_idx,
+                          RDFReaderGlobalState &state) {
+	unique_ptr<ParseCacheFile> cache;
+	try {
+		auto &file_path = bind_data.file_paths[file_idx];
+		cache = ParseCacheFile::Open(fs, ParseCachePath(fs, bind_data.cache_dir, file_path),
+		                             CreateCacheKey(fs, bind_data, file_path));
+	} catch (std::exception &) {
+	}
+	if (!cache) {
+		return false;
+	}
+	idx_t cache_size = 0;
+	for (idx_t group = 0; group < cache->GroupCount(); group++) {
+		cache_size += cache->GroupSize(group);
+	}
+	for (idx_t group = 0; group < cache->GroupCount(); group++) {
+		if (state.sample_fraction < 1.0 && !state.SampleRange()) {
+			continue;
+		}
+		RDFScanTask task;
+		task.file_idx = file_idx;
+		task.range_start = group;
+		task.range_end = group + 1;
+		task.cached = true;
+		task.sampled = true;
+		task.size = cache_size;
+		state.tasks.push_back(task);
+		state.total_bytes += cache->GroupSize(group);
+	}
+	return true;
+}
+
+// Splits an HDT file into runs of triples. Returns false if the file should be read whole.
+static bool AddHDTTasks(FileSystem &fs, idx_t file_idx, const string &file_path, idx_t file_size, bool memory_map,
+                        RDFReaderGlobalState &state) {
+	std::shared_ptr<HDTFile> hdt;
+	try {
+		hdt = HDTFile::Open(fs, file_path, memory_map);
+	} catch (std::exception &) {
+		return false; // reported when the file is read
+	}
+	for (idx_t start = 0; start < hdt->TripleCount(); start += RDFReaderGlobalState::HDT_RANGE_TRIPLES) {
+		RDFScanTask task;
+		task.file_idx = file_idx;
+		task.range_start = start;
+		task.range_end = MinValue<idx_t>(start + RDFReaderGlobalState::HDT_RANGE_TRIPLES, hdt->TripleCount());
+		task.hdt = hdt;
+		task.size = file_size;
+		state.tasks.push_back(task);
+	}
+	return true;
+}
+
+// Splits a large Turtle/TriG file into chunks at guessed statement boundaries.
+// Returns false if the file should be parsed whole.
+static bool AddSpeculativeTasks(FileSystem &fs, idx_t file_idx, const string &file_path, idx_t file_size,
+                                RDFReaderGlobalState &state) {
+	if (file_size <= RDFReaderGlobalState::SCAN_RANGE_SIZE) {
+		return false;
+	}
+	unique_ptr<SpeculativeTurtleFile> file;
+	try {
+		auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+		idx_t header_end = ScanTurtleHeader(*handle, file_size);
+		auto boundaries = GuessTurtleBoundaries(*handle, header_end, file_size, RDFReaderGlobalState::SCAN_RANGE_SIZE);
+		if (boundaries.size() <= 2) {
+			return false; // no plausible boundary found
+		}
+		file = make_uniq<SpeculativeTurtleFile>(header_end, boundaries);
+		string header(header_end, '\0');
+		if (header_end > 0) {
+			handle->Read(&header[0], header_end, 0);
+		}
+		file->header_directives = SerdBuffer::CountDirectives(header);
+	} catch (std::exception &) {
+		return false;
+	}
+	for (idx_t chunk_idx = 0; chunk_idx < file->chunks.size(); chunk_idx++) {
+		RDFScanTask task;
+		task.file_idx = file_idx;
+		task.range_start = file->chunks[chunk_idx].start;
+		task.range_end = file->chunks[chunk_idx].end;
+		task.chunk_idx = chunk_idx;
+		task.size = file_size;
+		state.tasks.push_back(task);
+	}
+	state.speculative_files[file_idx] = std::move(file);
+	return true;
+}
+
+// Splits a BGZF or seekable zstd file into runs of whole frames.
+// Returns false if the file is not made of independent frames.
+static bool AddFrameTasks(FileSystem &fs, idx_t file_idx, const string &file_path, const RDFFileInfo &info,
+                          idx_t range_size, RDFReaderGlobalState &state) {
+	vector<idx_t> boundaries;
+	try {
+		auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+		boundaries = FindFrameBoundaries(*handle, info.compression, info.size, range_size);
+	} catch (std::exception &) {
+		return false;
+	}
+	if (boundaries.empty()) {
+		return false;
+	}
+	for (idx_t i = 0; i + 1 < boundaries.size(); i++) {
+		if (state.sample_fraction < 1.0 && !state.SampleRange()) {
+			state.total_bytes -= (boundaries[i + 1] - boundaries[i]) * ESTIMATE_COMPRESSION_RATIO;
+			continue;
+		}
+		RDFScanTask task;
+		task.file_idx = file_idx;
+		task.range_start = boundaries[i];
+		task.range_end = boundaries[i + 1];
+		task.frames = true;
+		task.sampled = state.sample_fraction < 1.0;
+		task.size = info.size;
+		state.tasks.push_back(task);
+	}
+	return true;
+}
+
+// Tasks for the blocks of a zone index that may hold statements passing the filters on subject and
+// predicate, as runs of adjacent blocks of up to SCAN_RANGE_SIZE bytes. Returns the bytes of the tasks.
+static idx_t AddIndexTasks(idx_t file_idx, const RDFFileInfo &info, const ZoneIndex &index,
+                           const unique_ptr<RDFTermFilter> (&filters)[2], RDFReaderGlobalState &state) {
+	idx_t range_bytes = 0;
+	idx_t start = DConstants::INVALID_INDEX;
+	idx_t end = 0;
+	auto add_range = [&]() {
+		if (start == DConstants::INVALID_INDEX) {
+			return;
+		}
+		if (state.sample_fraction < 1.0 && !state.SampleRange()) {
+			state.total_bytes -= end - start;
+		} else {
+			// Blocks start at line starts, and a range holds the lines whose preceding byte it holds
+			RDFScanTask task;
+			task.file_idx = file_idx;
+			task.range_start = start == 0 ? 0 : start - 1;
+			task.range_end = end - 1;
+			task.sampled = state.sample_fraction < 1.0;
+			task.size = info.size;
+			state.tasks.push_back(task);
+			range_bytes += end - start;
+		}
+		start = DConstants::INVALID_INDEX;
+	};
+	for (auto &block : index.blocks) {
+		bool matches = block.statements > 0;
+		if (matches && block.bounded) {
+			matches = (!filters[0] || filters[0]->MatchesRange(block.min_subject, block.max_subject)) &&
+			          (!filters[1] || filters[1]->MatchesRange(block.min_predicate, block.max_predicate));
+		}
+		if (!matches) {
+			add_range();
+			state.total_bytes -= block.end - block.start;
+			state.index_blocks_pruned++;
+			continue;
+		}
+		state.index_blocks_scanned++;
+		if (start != DConstants::INVALID_INDEX && block.end - start > RDFReaderGlobalState::SCAN_RANGE_SIZE) {
+			add_range();
+		}
+		if (start == DConstants::INVALID_INDEX) {
+			start = block.start;
+		}
+		end = block.end;
+	}
+	add_range();
+	return range_bytes;
+}
+
+// Tasks for the lines of the byte range [start, end) of a file (see LineRangeReader), split into ranges
+// of up to SCAN_RANGE_SIZE bytes. Returns the bytes of the tasks.
+static idx_t AddRangeTasks(idx_t file_idx, idx_t start, idx_t end, idx_t file_size, RDFReaderGlobalState &state) {
+	// Blank node labels are scoped to the document and serd neither renames nor generates
+	// them for line formats, so every range of a file reports the same label for the same node.
+	// A sample keeps or skips smaller ranges, each realigned to whole lines like any other.
+	bool sampling = state.sample_fraction < 1.0;
+	idx_t range_size = sampling ? RDFReaderGlobalState::SAMPLE_RANGE_SIZE : RDFReaderGlobalState::SCAN_RANGE_SIZE;
+	idx_t range_bytes = 0;
+	for (idx_t range_start = start; range_start < end; range_start += range_size) {
+		idx_t range_end = MinValue<idx_t>(range_start + range_size, end);
+		if (sampling && !state.SampleRange()) {
+			state.total_bytes -= range_end - range_start;
+			continue;
+		}
+		RDFScanTask task;
+		task.file_idx = file_idx;
+		task.range_start = range_start;
+		task.range_end = range_end;
+		task.sampled = sampling;
+		task.size = file_size;
+		state.tasks.push_back(task);
+		range_bytes += range_end - range_start;
+	}
+	return range_bytes;
+}
+
+// The files whose filename and partition values pass the filters on those columns. The filters are
+// applied here, before any file is opened, and not again. The end offsets of the files kept are found
+// next, and then the filters on end_offset applied.
+static vector<idx_t> SelectFiles(ClientContext &context, FileSystem &fs, const RDFReaderBindData &bind_data,
+                                 TableFunctionInitInput &input, RDFReaderGlobalState &state) {
+	vector<pair<column_t, unique_ptr<RDFTermFilter>>> filters;
+	vector<pair<column_t, unique_ptr<RDFTermFilter>>> end_offset_filters;
+	if (input.filters) {
+		for (auto &entry : input.filters->filters) {
+			if (entry.first < input.column_ids.size() && IsFileColumn(bind_data, input.column_ids[entry.first])) {
+				auto col = input.column_ids[entry.first];
+				auto type = FileColumnValue(bind_data, 0, col, DConstants::INVALID_INDEX).type();
+				auto filter = RDFTermFilter::Create(context, *entry.second, type);
+				if (type.id() == LogicalTypeId::VARCHAR) {
+					filters.emplace_back(col, std::move(filter));
+				} else {
+					end_offset_filters.emplace_back(col, std::move(filter));
+				}
+			}
+		}
+	}
+	if (!bind_data.start_offsets.empty()) {
+		state.end_offsets.assign(bind_data.file_paths.size(), DConstants::INVALID_INDEX);
+	}
+	vector<idx_t> files;
+	for (idx_t file_idx = 0; file_idx < bind_data.file_paths.size(); file_idx++) {
+		bool matches = true;
+		for (auto &filter : filters) {
+			auto value = FileColumnValue(bind_data, file_idx, filter.first, DConstants::INVALID_INDEX);
+			auto str = value.IsNull() ? string() : StringValue::Get(value);
+			if (!filter.second->Matches(value.IsNull() ? nullptr : str.data(), str.size())) {
+				matches = false;
+				break;
+			}
+		}
+		if (!matches) {
+			continue;
+		}
+		auto &path = bind_data.file_paths[file_idx];
+		if (!state.end_offsets.empty() && IsResumableFile(fs, bind_data, path)) {
+			state.end_offsets[file_idx] = LastLineEnd(fs, path, bind_data.start_offsets[file_idx]);
+		}
+		for (auto &filter : end_offset_filters) {
+			auto value = FileColumnValue(bind_data, file_idx, filter.first, state.EndOffset(file_idx));
+			if (!filter.second->MatchesValue(value)) {
+				matches = false;
+				break;
+			}
+		}
+		if (matches) {
+			files.push_back(file_idx);
+		}
+	}
+	return files;
+}
+
+// Creates the shared global state; called once before any threads start scanning.
+// Tasks are handed out largest file first, so a big file is started early instead of being
+// left to one thread at the end; its ranges can be split again by idle threads.
 static unique_ptr<GlobalTableFunctionState> RDFReaderGlobalInit(ClientContext &context, TableFunctionInitInput &input) {
 	auto &bind_data = (RDFReaderBindData &)*input.bind_data;
+	auto &fs = FileSystem::GetFileSystem(context);
 	auto state = make_uniq<RDFReaderGlobalState>();
-	state->file_count = bind_data.file_paths.size();
+	if (bind_data.encode_terms) {
+		state->term_ids = RDFTermIds::Get(context);
+	}
+	// Speculative chunks are confirmed out of order, and their rows returned by whichever thread is free
+	state->ordered = DBConfig::GetConfig(context).options.preserve_insertion_order && !bind_data.speculative_parsing;
+	state->sample_fraction = bind_data.sample_fraction;
+	uint64_t seed = std::random_device()();
+	if (input.sample_options) {
+		// The optimizer only pushes down SYSTEM samples given as a percentage
+		auto &options = *input.sample_options;
+		state->sample_fraction *= options.sample_size.GetValue<double>() / 100.0;
+		if (options.seed.IsValid()) {
+			seed = options.seed.GetIndex();
+		}
+	}
+	state->sample_seed = seed;
+	state->sample_rng.seed(seed);
+	// Filters on subject and predicate, checked against the bounds of zone index blocks. Not with
+	// encode_terms, whose filters are on ids, nor compact_iris, which changes the terms filtered on.
+	unique_ptr<RDFTermFilter> index_filters[2];
+	if (input.filters && !bind_data.encode_terms && !bind_data.compact_iris) {
+		for (auto &entry : input.filters->filters) {
+			auto col = entry.first < input.column_ids.size() ? input.column_ids[entry.first] : COLUMN_IDENTIFIER_ROW_ID;
+			if (col == 1 || col == 2) {
+				index_filters[col - 1] = RDFTermFilter::Create(context, *entry.second);
+			}
+		}
+	}
+	idx_t range_bytes = 0;
+	RDFScanTask batch;
+	batch.file_idx = DConstants::INVALID_INDEX;
+	idx_t prev_file = DConstants::INVALID_INDEX;
+	auto flush_batch = [&]() {
+		if (batch.file_idx != DConstants::INVALID_INDEX) {
+			state->tasks.push_back(std::move(batch));
+		}
+		batch = RDFScanTask();
+		batch.file_idx = DConstants::INVALID_INDEX;
+	};
+
+	for (auto file_idx : SelectFiles(context, fs, bind_data, input, *state)) {
+		// In an ordered scan a batch only holds files that follow each other
+		if (state->ordered && batch.file_idx != DConstants::INVALID_INDEX &&
+		    (batch.batch.empty() ? batch.file_idx : batch.batch.back()) != prev_file) {
+			flush_batch();
+		}
+		prev_file = file_idx;
+		const string &file_path = bind_data.file_paths[file_idx];
+		auto ft = bind_data.file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(file_path) : bind_data.file_type;
+		bool pipe = IsPipeInput(fs, file_path);
+		if (pipe && ft == ITriplesBuffer::HDT) {
+			throw IOException("HDT files are read by seeking, and can't be read from a pipe: " + file_path);
+		}
+		// A file without an up to date cache is parsed whole, building its cache as it goes. HDT
+		// files are indexed already, and a pipe holds different bytes every time it is read.
+		// A file with an end offset is read from its start offset to there, whatever has been added since
+		bool windowed = state->EndOffset(file_idx) != DConstants::INVALID_INDEX;
+		bool caching = !bind_data.cache_dir.empty() && ft != ITriplesBuffer::HDT && !pipe && !windowed;
+		if (caching && AddCacheTasks(fs, bind_data, file_idx, *state)) {
+			continue;
+		}
+		// A sample never writes a cache: it would only hold the sampled statements
+		caching = caching && state->sample_fraction >= 1.0;
+		auto info = ProbeFile(fs, file_path);
+		if (windowed) {
+			// The start offset is a line start, or else the line it is in was read already. Either way
+			// the range starts at the byte before it, and ends at the newline before the end offset.
+			auto start = bind_data.start_offsets[file_idx];
+			auto end = state->end_offsets[file_idx];
+			if (end > start) {
+				state->total_bytes += end - start;
+				range_bytes += AddRangeTasks(file_idx, start == 0 ? 0 : start - 1, end - 1, info.size, *state);
+			}
+			continue;
+		}
+		state->total_bytes += info.size * (info.compression == RDFCompression::NONE ? 1 : ESTIMATE_COMPRESSION_RATIO);
+		if (!caching && bind_data.speculative_parsing && (ft == ITriplesBuffer::TURTLE || ft == ITriplesBuffer::TRIG) &&
+		    info.can_seek && AddSpeculativeTasks(fs, file_idx, file_path, info.size, *state)) {
+			continue;
+		}
+		if (ft == ITriplesBuffer::HDT && info.size >= RDFReaderGlobalState::SMALL_FILE_SIZE &&
+		    AddHDTTasks(fs, file_idx, file_path, info.size, bind_data.memory_map, *state)) {
+			continue;
+		}
+		if (!caching && IsSplittableFileType(ft) && info.compression == RDFCompression::NONE && info.can_seek) {
+			auto index = ZoneIndex::Open(fs, file_path, ft == ITriplesBuffer::NQUADS);
+			if (index) {
+				range_bytes += AddIndexTasks(file_idx, info, *index, index_filters, *state);
+				continue;
+			}
+		}
+		if (info.size < RDFReaderGlobalState::SMALL_FILE_SIZE) {
+			// Small files are parsed back to back by one thread rather than claimed one by one
+			if (batch.file_idx == DConstants::INVALID_INDEX) {
+				batch.file_idx = file_idx;
+			} else {
+				batch.batch.push_back(file_idx);
+			}
+			batch.size += info.size;
+			if (batch.size >= RDFReaderGlobalState::SCAN_RANGE_SIZE) {
+				flush_batch();
+			}
+			continue;
+		}
+		if (!caching && info.compression != RDFCompression::NONE && IsSplittableFileType(ft) &&
+		    info.size > bind_data.frame_range_size &&
+		    AddFrameTasks(fs, file_idx, file_path, info, bind_data.frame_range_size, *state)) {
+			continue;
+		}
+		if (caching || !IsSplittableFileType(ft) || !info.can_seek) {
+			RDFScanTask task;
+			task.file_idx = file_idx;
+			task.size = info.size;
+			state->tasks.push_back(task);
+			continue;
+		}
+		range_bytes += AddRangeTasks(file_idx, 0, info.size, info.size, *state);
+	}
+	flush_batch();
+
+	if (state->ordered) {
+		// Batches are pushed once full, after the tasks of files that follow them
+		std::stable_sort(state->tasks.begin(), state->tasks.end(),
+		                 [](const RDFScanTask &a, const RDFScanTask &b) { return a.file_idx < b.file_idx; });
+	} else {
+		// Stable, so the chunks of a speculatively split file keep their order
+		std::stable_sort(state->tasks.begin(), state->tasks.end(),
+		                 [](const RDFScanTask &a, const RDFScanTask &b) { return a.size > b.size; });
+	}
+	state->max_threads =
+	    MaxValue<idx_t>(state->tasks.size(), range_bytes / (2 * RDFReaderGlobalState::STEAL_MIN_SIZE));
 	return state;
 }
 
 // Creates thread-local state; file opening is deferred to RDFReaderFunc
 static unique_ptr<LocalTableFunctionState> RDFReaderInit(ExecutionContext &context, TableFunctionInitInput &input,
                                                          GlobalTableFunctionState *global_state) {
+	auto &bind_data = (RDFReaderBindData &)*input.bind_data;
 	auto state = make_uniq<RDFReaderLocalState>();
 	state->column_ids = input.column_ids;
+	state->filters = input.filters;
+	auto &gstate = (RDFReaderGlobalState &)*global_state;
+	state->sample_fraction = gstate.sample_fraction;
+	state->sample_seed = gstate.sample_seed;
+	state->thread_seq = gstate.next_thread++;
+	auto &term_ids = gstate.term_ids;
+	if (term_ids) {
+		state->encoder = make_uniq<RDFTermEncoder>(term_ids, input.column_ids);
+		state->column_ids = state->encoder->TermColumnIds();
+	}
+	if (input.filters) {
+		state->chunk_filter = RDFChunkFilter::Create(context.client, *input.filters, input.column_ids,
+		                                             bind_data.file_columns_start, bind_data.encode_terms);
+	}
+	// The file columns are filled per file here; the parsers leave them alone
+	for (idx_t i = 0; i < state->column_ids.size(); i++) {
+		if (IsFileColumn(bind_data, state->column_ids[i])) {
+			state->file_columns.emplace_back(i, state->column_ids[i]);
+			state->column_ids[i] = COLUMN_IDENTIFIER_ROW_ID;
+		}
+	}
 	return state;
 }
 
@@ -204,50 +1262,499 @@ static unique_ptr<ITriplesBuffer> OpenFile(const string &file_path, ITriplesBuff
 		return make_uniq<SerdBuffer>(file_path, "", &fs, strict_parsing, expand_prefixes, ft);
 	case ITriplesBuffer::XML:
 		return make_uniq<XMLBuffer>(file_path, "", &fs, strict_parsing, expand_prefixes, ft);
+	case ITriplesBuffer::HDT:
+		return make_uniq<HDTBuffer>(file_path, "", &fs, strict_parsing, expand_prefixes, ft);
 	default:
 		throw IOException("Cannot determine file type for: " + file_path);
 	}
 }
 
-static void RDFReaderFunc(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+// Routes the rows parsed from a speculative chunk: returned once the chunk is known to start at a
+// statement boundary, staged until then and dropped if it turns out to start mid-statement.
+// Returns true if output holds rows to return.
+static bool RouteSpeculativeRows(ClientContext &context, RDFReaderGlobalState &global_state,
+                                 RDFReaderLocalState &state, DataChunk &output) {
+	std::lock_guard<std::mutex> lk(global_state.lock);
+	auto &file = *global_state.speculative_files[state.task.file_idx];
+	auto &chunk = file.chunks[state.task.chunk_idx];
+	if (chunk.absorbed) {
+		output.Reset();
+		state.chunk_ib = nullptr;
+		state.ib.reset();
+		return false;
+	}
+	if (output.size() > 0) {
+		if (chunk.confirmed) {
+			return true;
+		}
+		if (!chunk.staged) {
+			chunk.staged = make_uniq<ColumnDataCollection>(context, output.GetTypes());
+		}
+		chunk.staged->Append(output);
+		output.Reset();
+		return false;
+	}
+
+	// The chunk's bytes are exhausted: settle its guessed boundaries
+	auto ib = state.chunk_ib;
+	state.chunk_ib = nullptr;
+	vector<idx_t> reparse;
+	file.Finish(state.task.chunk_idx, ib->Truncated(), ib->DeferredError(), ib->StatementCount(),
+	            ib->DirectiveCount(), global_state.ready_rows, reparse);
+	for (auto chunk_idx : reparse) {
+		RDFScanTask task = state.task;
+		task.chunk_idx = chunk_idx;
+		task.range_start = file.chunks[chunk_idx].start;
+		task.range_end = file.chunks[chunk_idx].end;
+		task.skip_statements = file.chunks[chunk_idx].statements;
+		global_state.tasks.push_back(task);
+	}
+	state.ib.reset();
+	return false;
+}
+
+// Splits the unread tail off the byte range with the most left to read. Requires the global lock.
+static bool StealRange(RDFReaderGlobalState &global_state, RDFScanTask &task) {
+	auto &active = global_state.active_ranges;
+	idx_t victim = DConstants::INVALID_INDEX;
+	idx_t most = 0;
+	for (idx_t i = 0; i < active.size();) {
+		idx_t remaining = active[i].claim->Remaining();
+		if (remaining == 0) {
+			// Finished, or read up to its end: it can't be split any more
+			active.erase(active.begin() + (int64_t)i);
+			continue;
+		}
+		if (remaining > most) {
+			most = remaining;
+			victim = i;
+		}
+		i++;
+	}
+	if (victim == DConstants::INVALID_INDEX) {
+		return false;
+	}
+	idx_t tail_end;
+	idx_t split = active[victim].claim->SplitTail(RDFReaderGlobalState::STEAL_MIN_SIZE, tail_end);
+	if (split == DConstants::INVALID_INDEX) {
+		return false;
+	}
+	task = RDFScanTask();
+	task.file_idx = active[victim].file_idx;
+	task.range_start = split;
+	task.range_end = tail_end;
+	// Byte ranges of a sample were all drawn whole
+	task.sampled = global_state.sample_fraction < 1.0;
+	return true;
+}
+
+// Opens a file and sets up its parser for the part of it described by the thread's current task
+static unique_ptr<ITriplesBuffer> OpenTaskBuffer(ClientContext &context, const RDFReaderBindData &bind_data,
+                                                 FileSystem &fs, RDFReaderLocalState &state, idx_t file_idx,
+                                                 idx_t header_end, bool last_chunk,
+                                                 std::shared_ptr<LineRangeClaim> claim) {
+	auto &task = state.task;
+	const string &file_path = bind_data.file_paths[file_idx];
+	unique_ptr<ITriplesBuffer> new_ib;
+	if (task.cached && file_idx == task.file_idx) {
+		new_ib = make_uniq<CacheBuffer>(fs, ParseCachePath(fs, bind_data.cache_dir, file_path),
+		                                CreateCacheKey(fs, bind_data, file_path), task.range_start, task.range_end);
+	} else {
+		auto ft =
+		    bind_data.file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(file_path) : bind_data.file_type;
+		bool caching = !bind_data.cache_dir.empty() && ft != ITriplesBuffer::HDT && !IsPipeInput(fs, file_path) &&
+		               state.sample_fraction >= 1.0 &&
+		               (file_idx != task.file_idx || task.range_end == DConstants::INVALID_INDEX);
+		// The key is taken before parsing: a file changed while it is parsed gets a cache that is stale
+		ParseCacheKey key;
+		if (caching) {
+			key = CreateCacheKey(fs, bind_data, file_path);
+		}
+		new_ib = OpenFile(file_path, bind_data.file_type, fs, bind_data.strict_parsing, bind_data.expand_prefixes);
+		if (file_idx == task.file_idx) {
+			new_ib->SetByteRange(task.range_start, task.range_end);
+			new_ib->SetRangeClaim(std::move(claim));
+		}
+		if (task.hdt && file_idx == task.file_idx) {
+			static_cast<HDTBuffer *>(new_ib.get())->SetFile(task.hdt);
+		}
+		if (task.chunk_idx != DConstants::INVALID_INDEX) {
+			// Speculative chunks are only created for Turtle/TriG, which are parsed by serd
+			static_cast<SerdBuffer *>(new_ib.get())
+			    ->SetSpeculativeChunk(header_end, task.chunk_idx, last_chunk, task.skip_statements);
+		}
+		new_ib->SetBufferSize(bind_data.buffer_size);
+		new_ib->SetMemoryMap(bind_data.memory_map);
+		new_ib->SetBufferManager(BufferManager::GetBufferManager(context));
+		if (state.sample_fraction < 1.0 && !(file_idx == task.file_idx && task.sampled)) {
+			// Seeded per file and range, so a repeatable sample does not depend on the thread
+			new_ib->SetSample(state.sample_fraction,
+			                  state.sample_seed ^ ((file_idx + 1) * 0x9e3779b97f4a7c15ULL) ^ task.range_start);
+		}
+		if (bind_data.compact_iris) {
+			auto compactor = std::unique_ptr<IRICompactor>(new IRICompactor());
+			for (auto &prefix : bind_data.prefixes) {
+				compactor->AddPrefix(prefix.first, prefix.second, false);
+			}
+			new_ib->SetCompactor(std::move(compactor));
+		}
+		if (caching) {
+			new_ib = make_uniq<CacheBuffer>(std::move(new_ib), fs, ParseCachePath(fs, bind_data.cache_dir, file_path),
+			                                key);
+		}
+	}
+	new_ib->StartParse();
+	new_ib->SetColumnIds(state.column_ids);
+	if (state.filters && !state.filters->filters.empty()) {
+		new_ib->SetFilter(
+		    make_uniq<RDFStatementFilter>(context, *state.filters, state.column_ids, bind_data.encode_terms));
+	}
+	// Only a file read whole by one task, which nothing else could parse in parallel, gets a thread
+	if (bind_data.pipelined_parsing && file_idx == task.file_idx && task.batch.empty() &&
+	    task.range_end == DConstants::INVALID_INDEX && task.chunk_idx == DConstants::INVALID_INDEX) {
+		new_ib = make_uniq<PipelinedBuffer>(file_path, std::move(new_ib));
+		new_ib->SetBufferManager(BufferManager::GetBufferManager(context));
+	}
+	return new_ib;
+}
+
+// Starts parsing a file of the thread's current task, and starts reading the next file of a batch
+static void StartTaskBuffer(ClientContext &context, const RDFReaderBindData &bind_data, FileSystem &fs,
+                            RDFReaderLocalState &state, idx_t file_idx, idx_t header_end, bool last_chunk,
+                            std::shared_ptr<LineRangeClaim> claim) {
+	auto &task = state.task;
+	try {
+		unique_ptr<ITriplesBuffer> new_ib;
+		if (state.prefetched && state.prefetched_file == file_idx) {
+			new_ib = std::move(state.prefetched);
+		} else {
+			new_ib = OpenTaskBuffer(context, bind_data, fs, state, file_idx, header_end, last_chunk, std::move(claim));
+		}
+		state.prefetched.reset();
+		state.prefetched_file = DConstants::INVALID_INDEX;
+		state.chunk_ib =
+		    task.chunk_idx != DConstants::INVALID_INDEX ? static_cast<SerdBuffer *>(new_ib.get()) : nullptr;
+		state.ib = std::move(new_ib);
+		state.ib_file = file_idx;
+		state.reported_bytes = 0;
+	} catch (const std::runtime_error &re) {
+		throw IOException(re.what());
+	}
+
+	if (state.batch_pos < task.batch.size()) {
+		auto next_file = task.batch[state.batch_pos];
+		try {
+			state.prefetched = OpenTaskBuffer(context, bind_data, fs, state, next_file, 0, true, nullptr);
+			state.prefetched->Prefetch();
+			state.prefetched_file = next_file;
+		} catch (std::exception &) {
+			// Raised again, in order, when the file's turn comes
+			state.prefetched.reset();
+		}
+	}
+}
+
+// Fills output with the next rows of the scan, as the parsers return them
+static void ScanTerms(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	auto &state = (RDFReaderLocalState &)*input.local_state;
 	auto &global_state = (RDFReaderGlobalState &)*input.global_state;
 	auto &bind_data = (RDFReaderBindData &)*input.bind_data;
 	auto &fs = FileSystem::GetFileSystem(context);
 
 	while (true) {
+		// Return the staged rows of a confirmed speculative chunk
+		if (state.ready_rows) {
+			state.ready_rows->Scan(state.ready_scan, output);
+			if (output.size() > 0) {
+				return;
+			}
+			state.ready_rows.reset();
+		}
+
 		// If we have an active buffer, try to get more rows from it
 		if (state.ib) {
 			state.ib->PopulateChunk(output);
+			if (output.size() > 0) {
+				for (auto &column : state.file_columns) {
+					auto end_offset = global_state.EndOffset(state.ib_file);
+					output.data[column.first].Reference(
+					    FileColumnValue(bind_data, state.ib_file, column.second, end_offset));
+				}
+			}
+			auto bytes_read = state.ib->BytesRead();
+			if (bytes_read > state.reported_bytes) {
+				global_state.bytes_read += bytes_read - state.reported_bytes;
+				state.reported_bytes = bytes_read;
+			}
+			if (state.chunk_ib) {
+				if (RouteSpeculativeRows(context, global_state, state, output)) {
+					return;
+				}
+				continue;
+			}
 			if (output.size() > 0) {
 				return;
 			}
-			// Buffer exhausted — drop it and claim the next file
+			// Buffer exhausted — drop it and claim the next task
 			state.ib.reset();
 		}
 
-		// Atomically claim the next file index
-		idx_t file_idx;
+		// The rest of a batch of small files is parsed by the thread that claimed it
+		if (state.batch_pos < state.task.batch.size()) {
+			StartTaskBuffer(context, bind_data, fs, state, state.task.batch[state.batch_pos++], 0, true, nullptr);
+			continue;
+		}
+
+		// Atomically claim the next task (a file, a byte range of one or a batch of small files),
+		// or once none are left, split the tail off a range another thread is still reading
+		idx_t header_end = 0;
+		bool last_chunk = true;
+		std::shared_ptr<LineRangeClaim> claim;
 		{
 			std::lock_guard<std::mutex> lk(global_state.lock);
-			if (global_state.next_file >= global_state.file_count) {
-				return; // no more files; empty output signals done to DuckDB
+			if (!global_state.ready_rows.empty()) {
+				state.ready_rows = std::move(global_state.ready_rows.back());
+				global_state.ready_rows.pop_back();
+				state.ready_rows->InitializeScan(state.ready_scan);
+				continue;
+			}
+			if (global_state.next_task < global_state.tasks.size()) {
+				state.task_seq = global_state.next_task;
+				state.task = global_state.tasks[global_state.next_task++];
+			} else if (global_state.ordered || !StealRange(global_state, state.task)) {
+				return; // no more work; empty output signals done to DuckDB
+			}
+			state.chunk_seq = 0;
+			state.batch_pos = 0;
+			if (state.task.chunk_idx != DConstants::INVALID_INDEX) {
+				auto &file = *global_state.speculative_files[state.task.file_idx];
+				header_end = file.header_end;
+				last_chunk = file.IsLastChunk(state.task.chunk_idx);
+			} else if (state.task.range_end != DConstants::INVALID_INDEX && !state.task.frames && !state.task.cached &&
+			           !state.task.hdt) {
+				claim = std::make_shared<LineRangeClaim>(state.task.range_start, state.task.range_end);
+				global_state.active_ranges.push_back(RDFActiveRange {state.task.file_idx, claim});
 			}
-			file_idx = global_state.next_file++;
 		}
 
-		// Open and start parsing the claimed file
-		const string &file_path = bind_data.file_paths[file_idx];
-		try {
-			auto new_ib =
-			    OpenFile(file_path, bind_data.file_type, fs, bind_data.strict_parsing, bind_data.expand_prefixes);
-			new_ib->StartParse();
-			new_ib->SetColumnIds(state.column_ids);
-			state.ib = std::move(new_ib);
-		} catch (const std::runtime_error &re) {
-			throw IOException(re.what());
+		// Open and start parsing the claimed file or range
+		StartTaskBuffer(context, bind_data, fs, state, state.task.file_idx, header_end, last_chunk, std::move(claim));
+	}
+}
+
+static void RDFReaderFunc(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = (RDFReaderLocalState &)*input.local_state;
+	if (!state.encoder && !state.chunk_filter) {
+		ScanTerms(context, input, output);
+		return;
+	}
+	if (state.encoder && state.terms.ColumnCount() == 0) {
+		state.terms.Initialize(Allocator::Get(context), state.encoder->TermTypes(output.GetTypes()));
+	}
+	// A chunk whose rows all fail the chunk filters is skipped
+	while (true) {
+		idx_t scanned;
+		if (state.encoder) {
+			state.terms.Reset();
+			ScanTerms(context, input, state.terms);
+			state.encoder->Encode(state.terms, output);
+			scanned = state.terms.size();
+		} else {
+			ScanTerms(context, input, output);
+			scanned = output.size();
+		}
+		if (state.chunk_filter) {
+			state.chunk_filter->Apply(output);
+		}
+		if (output.size() > 0 || scanned == 0) {
+			return;
 		}
+		output.Reset();
+	}
+}
+
+// The batch index of the chunk just returned, by which DuckDB restores insertion order when several
+// threads insert or copy the rows of a scan. Called once per chunk, and only when order matters.
+static OperatorPartitionData RDFReaderGetPartitionData(ClientContext &context, TableFunctionGetPartitionInput &input) {
+	if (input.partition_info.RequiresPartitionColumns()) {
+		throw InternalException("read_rdf does not support partition columns");
+	}
+	auto &state = (RDFReaderLocalState &)*input.local_state;
+	auto &global_state = (RDFReaderGlobalState &)*input.global_state;
+	if (!global_state.ordered) {
+		// Rows come in no particular order, but DuckDB still needs indices that differ between
+		// threads and grow within each: every thread numbers its chunks in a range of its own
+		auto chunk = MinValue<idx_t>(state.thread_chunks++, RDFReaderGlobalState::TASK_BATCHES - 1);
+		return OperatorPartitionData(state.thread_seq * RDFReaderGlobalState::TASK_BATCHES + chunk);
+	}
+	auto chunk = MinValue<idx_t>(state.chunk_seq++, RDFReaderGlobalState::TASK_BATCHES - 1);
+	return OperatorPartitionData(state.task_seq * RDFReaderGlobalState::TASK_BATCHES + chunk);
+}
+
+static unique_ptr<NodeStatistics> RDFReaderCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+	auto &bind_data = (const RDFReaderBindData &)*bind_data_p;
+	if (bind_data.estimated_statements == DConstants::INVALID_INDEX) {
+		return make_uniq<NodeStatistics>();
+	}
+	return make_uniq<NodeStatistics>(bind_data.estimated_statements);
+}
+
+// subject, predicate and object are never NULL, and graph is always NULL in files without graphs
+static unique_ptr<BaseStatistics> RDFReaderStatistics(ClientContext &context, const FunctionData *bind_data_p,
+                                                      column_t column_index) {
+	auto &bind_data = (const RDFReaderBindData &)*bind_data_p;
+	auto stats = bind_data.encode_terms && RDFTermEncoder::IsEncodedColumn(column_index)
+	                 ? BaseStatistics::CreateUnknown(LogicalType::BIGINT)
+	                 : StringStats::CreateUnknown(LogicalType::VARCHAR);
+	if (column_index == 0 && !bind_data.has_graphs) {
+		stats.Set(StatsInfo::CANNOT_HAVE_VALID_VALUES);
+		return stats.ToUnique();
+	}
+	if (column_index >= 1 && column_index <= 3 && bind_data.terms_not_null) {
+		stats.Set(StatsInfo::CANNOT_HAVE_NULL_VALUES);
+		return stats.ToUnique();
+	}
+	return nullptr;
+}
+
+// Percentage of the input the parsers have read
+static double RDFReaderProgress(ClientContext &context, const FunctionData *bind_data_p,
+                                const GlobalTableFunctionState *global_state_p) {
+	auto &global_state = (const RDFReaderGlobalState &)*global_state_p;
+	if (global_state.total_bytes == 0) {
+		return 100.0;
+	}
+	return MinValue<double>(100.0, 100.0 * (double)global_state.bytes_read.load() / (double)global_state.total_bytes);
+}
+
+static InsertionOrderPreservingMap<string> RDFReaderDynamicToString(TableFunctionDynamicToStringInput &input) {
+	InsertionOrderPreservingMap<string> result;
+	if (!input.global_state) {
+		return result;
+	}
+	auto &global_state = (const RDFReaderGlobalState &)*input.global_state;
+	if (global_state.index_blocks_scanned + global_state.index_blocks_pruned > 0) {
+		result["Index Blocks Scanned"] = std::to_string(global_state.index_blocks_scanned);
+		result["Index Blocks Pruned"] = std::to_string(global_state.index_blocks_pruned);
+	}
+	return result;
+}
+
+// ============================================================
+// rdf_terms(): the terms behind the ids of encode_terms
+// ============================================================
+
+struct RDFTermsGlobalState : public GlobalTableFunctionState {
+	shared_ptr<RDFTermIds> term_ids;
+	// The next term to return
+	idx_t shard = 0;
+	idx_t pos = 0;
+};
+
+static unique_ptr<FunctionData> RDFTermsBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"id", "term", "datatype", "lang"};
+	return_types = {LogicalType::BIGINT, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> RDFTermsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<RDFTermsGlobalState>();
+	state->term_ids = RDFTermIds::Get(context);
+	return state;
+}
+
+// Terms added while the dictionary is listed may be left out
+static void RDFTermsFunc(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = (RDFTermsGlobalState &)*input.global_state;
+	while (state.shard < RDFTermIds::SHARD_COUNT && output.size() < STANDARD_VECTOR_SIZE) {
+		auto count = state.term_ids->Scan(state.shard, state.pos, output);
+		output.SetCardinality(output.size() + count);
+		state.pos += count;
+		if (output.size() < STANDARD_VECTOR_SIZE) {
+			state.shard++;
+			state.pos = 0;
+		}
+	}
+}
+
+// ============================================================
+// rdf_build_index(path): writes the zone index of NTriples and NQuads files
+// ============================================================
+
+struct RDFBuildIndexBindData : public TableFunctionData {
+	vector<string> file_paths;
+	vector<bool> quads;
+	idx_t block_size = ZoneIndex::DEFAULT_BLOCK_SIZE;
+};
+
+struct RDFBuildIndexGlobalState : public GlobalTableFunctionState {
+	idx_t next_file = 0;
+};
+
+static unique_ptr<FunctionData> RDFBuildIndexBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<RDFBuildIndexBindData>();
+	auto &fs = FileSystem::GetFileSystem(context);
+	string pattern = input.inputs[0].GetValue<string>();
+	auto glob_results = fs.Glob(pattern);
+	if (glob_results.empty()) {
+		throw IOException("No files found matching: " + pattern);
+	}
+	auto file_type = ITriplesBuffer::UNKNOWN;
+	auto file_type_param = input.named_parameters.find(FILE_TYPE);
+	if (file_type_param != input.named_parameters.end()) {
+		file_type = ParseFileTypeString(file_type_param->second.GetValue<string>());
+	}
+	for (auto &info : glob_results) {
+		auto ft = file_type == ITriplesBuffer::UNKNOWN ? DetectFileTypeFromPath(info.path) : file_type;
+		if (ft != ITriplesBuffer::NTRIPLES && ft != ITriplesBuffer::NQUADS) {
+			throw InvalidInputException("rdf_build_index only indexes NTriples and NQuads files: " + info.path);
+		}
+		// Blocks are read at their offsets in the file
+		string stem;
+		if (CompressionFromPath(info.path, stem) != RDFCompression::NONE || IsPipeInput(fs, info.path)) {
+			throw InvalidInputException("rdf_build_index can't index compressed files or pipes: " + info.path);
+		}
+		result->file_paths.push_back(info.path);
+		result->quads.push_back(ft == ITriplesBuffer::NQUADS);
+	}
+
+	auto block_size_param = input.named_parameters.find(BLOCK_SIZE);
+	if (block_size_param != input.named_parameters.end()) {
+		auto block_size = block_size_param->second.GetValue<int64_t>();
+		if (block_size < (int64_t)ReadAheadBuffer::MIN_BUFFER_SIZE) {
+			throw InvalidInputException("block_size must be at least %llu bytes",
+			                            (unsigned long long)ReadAheadBuffer::MIN_BUFFER_SIZE);
+		}
+		result->block_size = (idx_t)block_size;
+	}
+
+	names = {"file", "blocks", "statements", "subjects_sorted"};
+	return_types = {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BOOLEAN};
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> RDFBuildIndexInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<RDFBuildIndexGlobalState>();
+}
+
+// One row per file, each file indexed by the call that returns its row
+static void RDFBuildIndexFunc(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = (RDFBuildIndexBindData &)*input.bind_data;
+	auto &state = (RDFBuildIndexGlobalState &)*input.global_state;
+	auto &fs = FileSystem::GetFileSystem(context);
+	if (state.next_file >= bind_data.file_paths.size()) {
+		return;
 	}
+	idx_t file_idx = state.next_file++;
+	auto &path = bind_data.file_paths[file_idx];
+	auto index = ZoneIndex::Build(fs, path, bind_data.quads[file_idx], bind_data.block_size);
+	output.SetValue(0, 0, Value(path));
+	output.SetValue(1, 0, Value::BIGINT((int64_t)index->blocks.size()));
+	output.SetValue(2, 0, Value::BIGINT((int64_t)index->StatementCount()));
+	output.SetValue(3, 0, Value::BOOLEAN(index->SubjectsSorted()));
+	output.SetCardinality(1);
 }
 
 // ============================================================
@@ -642,8 +2149,40 @@ static void LoadInternal(ExtensionLoader &loader) {
 	tf.named_parameters[STRICT_PARSING] = LogicalType::BOOLEAN;
 	tf.named_parameters[PREFIX_EXPANSION] = LogicalType::BOOLEAN;
 	tf.named_parameters[FILE_TYPE] = LogicalType::VARCHAR;
+	tf.named_parameters[SPECULATIVE] = LogicalType::BOOLEAN;
+	tf.named_parameters[PIPELINED_PARSING] = LogicalType::BOOLEAN;
+	tf.named_parameters[TYPED_OBJECTS] = LogicalType::BOOLEAN;
+	tf.named_parameters[BUFFER_SIZE] = LogicalType::BIGINT;
+	tf.named_parameters[MEMORY_MAP] = LogicalType::BOOLEAN;
+	tf.named_parameters[CACHE_DIR] = LogicalType::VARCHAR;
+	tf.named_parameters[ENCODE_TERMS] = LogicalType::BOOLEAN;
+	tf.named_parameters[COMPACT_IRIS] = LogicalType::BOOLEAN;
+	tf.named_parameters[PREFIXES] = LogicalType::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR);
+	tf.named_parameters[FILENAME] = LogicalType::BOOLEAN;
+	tf.named_parameters[HIVE_PARTITIONING] = LogicalType::BOOLEAN;
+	tf.named_parameters[SAMPLE_FRACTION] = LogicalType::DOUBLE;
+	tf.named_parameters[START_OFFSETS] = LogicalType::MAP(LogicalType::VARCHAR, LogicalType::BIGINT);
+	tf.named_parameters[END_OFFSET] = LogicalType::BOOLEAN;
+	tf.named_parameters[FRAME_RANGE_SIZE] = LogicalType::BIGINT;
+	tf.cardinality = RDFReaderCardinality;
+	tf.statistics = RDFReaderStatistics;
+	tf.table_scan_progress = RDFReaderProgress;
+	tf.dynamic_to_string = RDFReaderDynamicToString;
+	tf.get_partition_data = RDFReaderGetPartitionData;
+	// SYSTEM samples are taken by the scan, see RDFReaderGlobalState::sample_fraction
+	tf.sampling_pushdown = true;
 	tf.projection_pushdown = true;
+	// Filters are applied exactly (in the parser callbacks or by RDFChunkFilter), so no re-check is needed
+	tf.filter_pushdown = true;
+	tf.filter_prune = false;
 	loader.RegisterFunction(tf);
+	TableFunction terms_tf("rdf_terms", {}, RDFTermsFunc, RDFTermsBind, RDFTermsInit);
+	loader.RegisterFunction(terms_tf);
+	TableFunction build_index_tf("rdf_build_index", {LogicalType::VARCHAR}, RDFBuildIndexFunc, RDFBuildIndexBind,
+	                             RDFBuildIndexInit);
+	build_index_tf.named_parameters[FILE_TYPE] = LogicalType::VARCHAR;
+	build_index_tf.named_parameters[BLOCK_SIZE] = LogicalType::BIGINT;
+	loader.RegisterFunction(build_index_tf);
 	auto can_call_inside_out_scalar_function =
 	    ScalarFunction("can_call_inside_out", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, CanCallInsideOut);
 	loader.RegisterFunction(can_call_inside_out_scalar_function);
@@ -0,0 +1,424 @@
+#include "include/rdf_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/null_filter.hpp"
+#include "duckdb/planner/filter/optional_filter.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace duckdb;
+
+// Bytewise comparison, the order DuckDB uses for VARCHAR
+static int CompareTerm(const char *data, idx_t len, const std::string &constant) {
+	idx_t n = MinValue<idx_t>(len, constant.size());
+	int cmp = n > 0 ? memcmp(data, constant.data(), n) : 0;
+	if (cmp != 0) {
+		return cmp;
+	}
+	return len < constant.size() ? -1 : (len > constant.size() ? 1 : 0);
+}
+
+static bool IsByteComparison(ExpressionType comparison) {
+	switch (comparison) {
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_NOTEQUAL:
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool CompareMatches(ExpressionType comparison, int cmp) {
+	switch (comparison) {
+	case ExpressionType::COMPARE_EQUAL:
+		return cmp == 0;
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return cmp != 0;
+	case ExpressionType::COMPARE_LESSTHAN:
+		return cmp < 0;
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return cmp > 0;
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return cmp <= 0;
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return cmp >= 0;
+	default:
+		throw InternalException("Unsupported comparison in read_rdf filter");
+	}
+}
+
+static bool IsStringConstant(const Value &value) {
+	return !value.IsNull() && value.type().id() == LogicalTypeId::VARCHAR;
+}
+
+unique_ptr<RDFTermFilter> RDFTermFilter::CreateExpression(ClientContext &context, unique_ptr<Expression> expr) {
+	// prefix(), suffix() and contains() against a constant are matched on the raw bytes;
+	// LIKE 'abc%' reaches us as prefix() after DuckDB's optimizer has rewritten it
+	if (expr->expression_class == ExpressionClass::BOUND_FUNCTION) {
+		auto &func = expr->Cast<BoundFunctionExpression>();
+		if (func.children.size() == 2 && func.children[0]->expression_class == ExpressionClass::BOUND_REF &&
+		    func.children[1]->expression_class == ExpressionClass::BOUND_CONSTANT) {
+			auto &value = func.children[1]->Cast<BoundConstantExpression>().value;
+			auto &name = func.function.name;
+			if (IsStringConstant(value)) {
+				unique_ptr<RDFTermFilter> result;
+				if (name == "prefix" || name == "starts_with") {
+					result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::PREFIX));
+				} else if (name == "suffix" || name == "ends_with") {
+					result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::SUFFIX));
+				} else if (name == "contains") {
+					result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::CONTAINS));
+				}
+				if (result) {
+					result->constant = StringValue::Get(value);
+					return result;
+				}
+			}
+		}
+	}
+	// Anything else is evaluated by DuckDB on the term's value
+	auto result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::EXPRESSION));
+	result->context = &context;
+	result->expression = make_uniq<ExpressionFilter>(std::move(expr));
+	return result;
+}
+
+unique_ptr<RDFTermFilter> RDFTermFilter::Create(ClientContext &context, const TableFilter &filter,
+                                                const LogicalType &type) {
+	unique_ptr<RDFTermFilter> result;
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &constant_filter = filter.Cast<ConstantFilter>();
+		if (!IsStringConstant(constant_filter.constant) || !IsByteComparison(constant_filter.comparison_type)) {
+			break;
+		}
+		result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::COMPARE));
+		result->comparison = constant_filter.comparison_type;
+		result->constant = StringValue::Get(constant_filter.constant);
+		return result;
+	}
+	case TableFilterType::IS_NULL:
+		return unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::IS_NULL));
+	case TableFilterType::IS_NOT_NULL:
+		return unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::IS_NOT_NULL));
+	case TableFilterType::CONJUNCTION_AND:
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &conjunction = filter.Cast<ConjunctionFilter>();
+		result = unique_ptr<RDFTermFilter>(
+		    new RDFTermFilter(filter.filter_type == TableFilterType::CONJUNCTION_AND ? Type::AND : Type::OR));
+		for (auto &child : conjunction.child_filters) {
+			result->children.push_back(Create(context, *child, type));
+		}
+		return result;
+	}
+	case TableFilterType::IN_FILTER: {
+		auto &in_filter = filter.Cast<InFilter>();
+		result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::IN));
+		for (auto &value : in_filter.values) {
+			if (value.IsNull()) {
+				continue;
+			}
+			if (!IsStringConstant(value)) {
+				result.reset();
+				break;
+			}
+			result->values.push_back(StringValue::Get(value));
+		}
+		if (!result) {
+			break;
+		}
+		std::sort(result->values.begin(), result->values.end());
+		return result;
+	}
+	case TableFilterType::OPTIONAL_FILTER: {
+		// Optional filters hold for every row of the result, so applying them is always safe
+		auto &optional_filter = filter.Cast<OptionalFilter>();
+		if (optional_filter.child_filter) {
+			return Create(context, *optional_filter.child_filter, type);
+		}
+		return unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::AND));
+	}
+	case TableFilterType::DYNAMIC_FILTER: {
+		result = unique_ptr<RDFTermFilter>(new RDFTermFilter(Type::DYNAMIC));
+		result->dynamic_data = filter.Cast<DynamicFilter>().filter_data;
+		return result;
+	}
+	case TableFilterType::EXPRESSION_FILTER:
+		return CreateExpression(context, filter.Cast<ExpressionFilter>().expr->Copy());
+	default:
+		break;
+	}
+	// Filters without a byte-level equivalent are evaluated as expressions over the column
+	return CreateExpression(context, filter.ToExpression(BoundReferenceExpression(type, 0)));
+}
+
+bool RDFTermFilter::Matches(const char *data, idx_t len) const {
+	switch (type) {
+	case Type::COMPARE:
+		return data && CompareMatches(comparison, CompareTerm(data, len, constant));
+	case Type::IS_NULL:
+		return !data;
+	case Type::IS_NOT_NULL:
+		return data != nullptr;
+	case Type::IN: {
+		if (!data) {
+			return false;
+		}
+		auto it = std::lower_bound(values.begin(), values.end(), data, [len](const std::string &value, const char *term) {
+			return CompareTerm(term, len, value) > 0;
+		});
+		return it != values.end() && CompareTerm(data, len, *it) == 0;
+	}
+	case Type::PREFIX:
+		return data && len >= constant.size() && memcmp(data, constant.data(), constant.size()) == 0;
+	case Type::SUFFIX:
+		return data && len >= constant.size() &&
+		       memcmp(data + len - constant.size(), constant.data(), constant.size()) == 0;
+	case Type::CONTAINS:
+		return data && (constant.empty() || std::search(data, data + len, constant.begin(), constant.end()) != data + len);
+	case Type::AND:
+		for (auto &child : children) {
+			if (!child->Matches(data, len)) {
+				return false;
+			}
+		}
+		return true;
+	case Type::OR:
+		for (auto &child : children) {
+			if (child->Matches(data, len)) {
+				return true;
+			}
+		}
+		return false;
+	case Type::DYNAMIC:
+		return !dynamic_active || (data && CompareMatches(comparison, CompareTerm(data, len, constant)));
+	case Type::EXPRESSION:
+		return expression->EvaluateWithConstant(*context, data ? Value(string(data, len)) : Value(LogicalType::VARCHAR));
+	default:
+		// DEFERRED
+		return true;
+	}
+}
+
+bool RDFTermFilter::MatchesValue(const Value &value) const {
+	switch (type) {
+	case Type::IS_NULL:
+		return value.IsNull();
+	case Type::IS_NOT_NULL:
+		return !value.IsNull();
+	case Type::AND:
+		for (auto &child : children) {
+			if (!child->MatchesValue(value)) {
+				return false;
+			}
+		}
+		return true;
+	case Type::OR:
+		for (auto &child : children) {
+			if (child->MatchesValue(value)) {
+				return true;
+			}
+		}
+		return false;
+	case Type::EXPRESSION:
+		return expression->EvaluateWithConstant(*context, value);
+	default:
+		// Dynamic filters only narrow a join or top-N that re-checks its input
+		return true;
+	}
+}
+
+bool RDFTermFilter::MatchesRange(const std::string &min, const std::string &max) const {
+	switch (type) {
+	case Type::COMPARE: {
+		int min_cmp = CompareTerm(min.data(), min.size(), constant);
+		int max_cmp = CompareTerm(max.data(), max.size(), constant);
+		switch (comparison) {
+		case ExpressionType::COMPARE_EQUAL:
+			return min_cmp <= 0 && max_cmp >= 0;
+		case ExpressionType::COMPARE_NOTEQUAL:
+			return min_cmp != 0 || max_cmp != 0;
+		case ExpressionType::COMPARE_LESSTHAN:
+			return min_cmp < 0;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			return min_cmp <= 0;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			return max_cmp > 0;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			return max_cmp >= 0;
+		default:
+			return true;
+		}
+	}
+	case Type::IS_NULL:
+		return false;
+	case Type::IN: {
+		auto it = std::lower_bound(values.begin(), values.end(), min);
+		return it != values.end() && CompareTerm(max.data(), max.size(), *it) >= 0;
+	}
+	case Type::PREFIX:
+		// Terms with the prefix sort from the prefix itself up to just before the first term above
+		// it without it
+		if (CompareTerm(min.data(), min.size(), constant) <= 0) {
+			return CompareTerm(max.data(), max.size(), constant) >= 0;
+		}
+		return min.compare(0, constant.size(), constant) == 0;
+	case Type::AND:
+		for (auto &child : children) {
+			if (!child->MatchesRange(min, max)) {
+				return false;
+			}
+		}
+		return true;
+	case Type::OR:
+		for (auto &child : children) {
+			if (child->MatchesRange(min, max)) {
+				return true;
+			}
+		}
+		return false;
+	default:
+		return true;
+	}
+}
+
+bool RDFTermFilter::EqualityConstant(std::string &value) const {
+	if (type == Type::COMPARE && comparison == ExpressionType::COMPARE_EQUAL) {
+		value = constant;
+		return true;
+	}
+	if (type == Type::AND) {
+		for (auto &child : children) {
+			if (child->EqualityConstant(value)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool RDFTermFilter::HasExpression() const {
+	if (type == Type::EXPRESSION) {
+		return true;
+	}
+	for (auto &child : children) {
+		if (child->HasExpression()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void RDFTermFilter::DeferExpressions() {
+	if (type == Type::EXPRESSION) {
+		type = Type::DEFERRED;
+		expression.reset();
+	}
+	for (auto &child : children) {
+		child->DeferExpressions();
+	}
+}
+
+void RDFTermFilter::Refresh() {
+	if (type == Type::DYNAMIC) {
+		std::lock_guard<std::mutex> lk(dynamic_data->lock);
+		dynamic_active = dynamic_data->initialized && dynamic_data->filter &&
+		                 IsStringConstant(dynamic_data->filter->constant) &&
+		                 IsByteComparison(dynamic_data->filter->comparison_type);
+		if (dynamic_active) {
+			comparison = dynamic_data->filter->comparison_type;
+			constant = StringValue::Get(dynamic_data->filter->constant);
+		}
+	}
+	for (auto &child : children) {
+		child->Refresh();
+	}
+}
+
+RDFStatementFilter::RDFStatementFilter(ClientContext &context, const TableFilterSet &filters,
+                                       const vector<column_t> &column_ids, bool encoded_terms) {
+	for (auto &entry : filters.filters) {
+		if (entry.first >= column_ids.size() || column_ids[entry.first] >= 6 ||
+		    (encoded_terms && column_ids[entry.first] <= 3)) {
+			continue;
+		}
+		auto column = column_ids[entry.first];
+		auto filter = RDFTermFilter::Create(context, *entry.second);
+		// The parts of the filter that compare bytes still drop statements here; RDFChunkFilter
+		// checks the whole filter on the output
+		filter->DeferExpressions();
+		if (_columns[column]) {
+			// Two filters on one column: both must hold
+			auto both = unique_ptr<RDFTermFilter>(new RDFTermFilter(RDFTermFilter::Type::AND));
+			both->children.push_back(std::move(_columns[column]));
+			both->children.push_back(std::move(filter));
+			filter = std::move(both);
+		}
+		_columns[column] = std::move(filter);
+	}
+}
+
+void RDFStatementFilter::Refresh() {
+	for (auto &column : _columns) {
+		if (column) {
+			column->Refresh();
+		}
+	}
+}
+
+unique_ptr<RDFChunkFilter> RDFChunkFilter::Create(ClientContext &context, const TableFilterSet &filters,
+                                                  const vector<column_t> &column_ids, idx_t column_count,
+                                                  bool encoded_terms) {
+	vector<unique_ptr<Expression>> conditions;
+	for (auto &entry : filters.filters) {
+		if (entry.first >= column_ids.size() || column_ids[entry.first] >= column_count) {
+			continue;
+		}
+		auto column = column_ids[entry.first];
+		LogicalType type;
+		if (encoded_terms && column <= 3) {
+			type = LogicalType::BIGINT;
+		} else if (column < 6) {
+			if (!RDFTermFilter::Create(context, *entry.second)->HasExpression()) {
+				continue;
+			}
+			type = LogicalType::VARCHAR;
+		} else {
+			type = TypedObjectBatch::ColumnType(column - 6);
+		}
+		// The chunk holds the columns of the scan in the order of column_ids
+		conditions.push_back(entry.second->ToExpression(BoundReferenceExpression(type, entry.first)));
+	}
+	if (conditions.empty()) {
+		return nullptr;
+	}
+	auto expression = std::move(conditions[0]);
+	for (idx_t i = 1; i < conditions.size(); i++) {
+		expression = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND, std::move(expression),
+		                                                   std::move(conditions[i]));
+	}
+	return unique_ptr<RDFChunkFilter>(new RDFChunkFilter(context, std::move(expression)));
+}
+
+RDFChunkFilter::RDFChunkFilter(ClientContext &context, unique_ptr<Expression> expression)
+    : _expression(std::move(expression)), _executor(context, *_expression), _sel(STANDARD_VECTOR_SIZE) {
+}
+
+void RDFChunkFilter::Apply(DataChunk &chunk) {
+	if (chunk.size() == 0) {
+		return;
+	}
+	auto count = _executor.SelectExpression(chunk, _sel);
+	if (count < chunk.size()) {
+		chunk.Slice(_sel, count);
+	}
+}
@@ -264,7 +264,7 @@ void RdfXmlParser::processAttributes(int nb_attributes, const xmlChar **attribut
 		if (!isReservedAttr(attr_uri)) {
 			std::string val((const char *)attributes[i * 5 + 3],
 			                (const char *)attributes[i * 5 + 4] - (const char *)attributes[i * 5 + 3]);
-			emit(subject, attr_uri, val, "", lang);
+			emit(subject, attr_uri, val, "", lang, true);
 		}
 	}
 }
@@ -393,7 +393,8 @@ void RdfXmlParser::onEndElement(void *ctx, const xmlChar *localname, const xmlCh
 		auto dt = (current.type == ElementType::PROPERTY_XML_LITERAL) ? self->RDF_XMLLITERAL_URI : current.datatype;
 		auto lit_lang = dt.empty() ? current.lang : "";
 		if (!self->_stack.empty()) {
-			self->emitWithReification(self->_stack.back().uri, current.uri, text, dt, lit_lang, current.reify_id);
+			self->emitWithReification(self->_stack.back().uri, current.uri, text, dt, lit_lang, current.reify_id,
+			                          true);
 		}
 	}
 }
@@ -411,19 +412,20 @@ void RdfXmlParser::onCharacters(void *ctx, const xmlChar *ch, int len) {
 }
 
 void RdfXmlParser::emitWithReification(const std::string &s, const std::string &p, const std::string &o,
-                                       const std::string &dt, const std::string &lang, const std::string &r_id) {
-	emit(s, p, o, dt, lang);
+                                       const std::string &dt, const std::string &lang, const std::string &r_id,
+                                       bool literal) {
+	emit(s, p, o, dt, lang, literal);
 	if (!r_id.empty()) {
 		emit(r_id, RDF_TYPE_URI, RDF_STATEMENT_URI, "", "");
 		emit(r_id, RDF_SUBJECT_URI, s, "", "");
 		emit(r_id, RDF_PREDICATE_URI, p, "", "");
-		emit(r_id, RDF_OBJECT_URI, o, dt, lang);
+		emit(r_id, RDF_OBJECT_URI, o, dt, lang, literal);
 	}
 }
 
 void RdfXmlParser::emit(const std::string &s, const std::string &p, const std::string &o, const std::string &dt,
-                        const std::string &lang) {
-	on_statement({s, p, o, dt, lang});
+                        const std::string &lang, bool literal) {
+	on_statement({s, p, o, dt, lang, literal});
 }
 
 std::string RdfAttributes::getSubject(RdfXmlParser *parser) const {
@@ -0,0 +1,157 @@
+#include "include/read_ahead.hpp"
+#include <cstring>
+
+using duckdb::idx_t;
+
+constexpr idx_t ReadAheadBuffer::DEFAULT_BUFFER_SIZE;
+constexpr idx_t ReadAheadBuffer::MIN_BUFFER_SIZE;
+constexpr idx_t ReadAheadBuffer::BLOCK_COUNT;
+
+ReadAheadBuffer::ReadAheadBuffer(Source source, idx_t buffer_size)
+    : _source(std::move(source)), _blocks(BLOCK_COUNT), _sizes(BLOCK_COUNT, 0) {
+	buffer_size = std::max<idx_t>(buffer_size, MIN_BUFFER_SIZE);
+	for (idx_t i = 0; i < BLOCK_COUNT; i++) {
+		_blocks[i].resize(buffer_size);
+		_free.push_back(i);
+	}
+}
+
+ReadAheadBuffer::~ReadAheadBuffer() {
+	{
+		std::lock_guard<std::mutex> lk(_lock);
+		_stop = true;
+	}
+	_free_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+idx_t ReadAheadBuffer::Read(char *buf, idx_t len) {
+	idx_t copied = 0;
+	while (copied < len) {
+		if (_current == duckdb::DConstants::INVALID_INDEX || _current_pos == _sizes[_current]) {
+			if (!NextBlock()) {
+				break;
+			}
+			continue;
+		}
+		idx_t n = std::min<idx_t>(len - copied, _sizes[_current] - _current_pos);
+		memcpy(buf + copied, _blocks[_current].data() + _current_pos, n);
+		_current_pos += n;
+		copied += n;
+	}
+	_bytes_read += copied;
+	return copied;
+}
+
+bool ReadAheadBuffer::Finished() {
+	std::lock_guard<std::mutex> lk(_lock);
+	bool current_done = _current == duckdb::DConstants::INVALID_INDEX || _current_pos == _sizes[_current];
+	return _started && current_done && _ready.empty() && _source_done && !_error;
+}
+
+void ReadAheadBuffer::Prefetch() {
+	std::lock_guard<std::mutex> lk(_lock);
+	if (!_started) {
+		_started = true;
+		StartThread();
+	}
+}
+
+bool ReadAheadBuffer::NextBlock() {
+	std::unique_lock<std::mutex> lk(_lock);
+	if (_current != duckdb::DConstants::INVALID_INDEX) {
+		_free.push_back(_current);
+		_current = duckdb::DConstants::INVALID_INDEX;
+		_free_cv.notify_one();
+	}
+	if (!_started) {
+		// The first block is read here; a source that fits in it never needs the thread
+		_started = true;
+		idx_t block = _free.front();
+		_free.pop_front();
+		lk.unlock();
+		bool end = false;
+		idx_t size = FillBlock(_blocks[block], end);
+		lk.lock();
+		_sizes[block] = size;
+		_current = block;
+		_current_pos = 0;
+		if (end) {
+			_source_done = true;
+		} else {
+			StartThread();
+		}
+		return size > 0;
+	}
+	_ready_cv.wait(lk, [&] { return !_ready.empty() || _source_done; });
+	if (!_ready.empty()) {
+		_current = _ready.front();
+		_ready.pop_front();
+		_current_pos = 0;
+		return true;
+	}
+	if (_error) {
+		std::rethrow_exception(_error);
+	}
+	return false;
+}
+
+idx_t ReadAheadBuffer::FillBlock(std::vector<char> &block, bool &end) {
+	idx_t size = 0;
+	while (size < block.size()) {
+		idx_t read = _source(block.data() + size, block.size() - size);
+		if (read == 0) {
+			end = true;
+			break;
+		}
+		size += read;
+	}
+	return size;
+}
+
+// Requires the lock
+void ReadAheadBuffer::StartThread() {
+	_thread = std::thread([this] { Run(); });
+}
+
+void ReadAheadBuffer::Run() {
+	while (true) {
+		idx_t block;
+		{
+			std::unique_lock<std::mutex> lk(_lock);
+			_free_cv.wait(lk, [&] { return !_free.empty() || _stop; });
+			if (_stop) {
+				return;
+			}
+			block = _free.front();
+			_free.pop_front();
+		}
+		bool end = false;
+		idx_t size = 0;
+		try {
+			size = FillBlock(_blocks[block], end);
+		} catch (...) {
+			std::lock_guard<std::mutex> lk(_lock);
+			_error = std::current_exception();
+			_source_done = true;
+			_ready_cv.notify_one();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lk(_lock);
+			_sizes[block] = size;
+			if (size > 0) {
+				_ready.push_back(block);
+			} else {
+				_free.push_back(block);
+			}
+			_source_done = end;
+		}
+		_ready_cv.notify_one();
+		if (end) {
+			return;
+		}
+	}
+}
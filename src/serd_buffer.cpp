@@ -3,8 +3,14 @@
 #include "duckdb/common/exception.hpp"
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
 #include <memory>
 
+// Bytes read at a time by the NTriples/NQuads fast path
+static constexpr idx_t NTRIPLES_BLOCK_SIZE = 256 * 1024;
+// Bytes serd takes from the read-ahead buffer at a time
+static constexpr size_t SERD_PAGE_SIZE = 64 * 1024;
+
 static SerdSyntax MapSyntaxFromFileType(ITriplesBuffer::FileType file_type) {
 	switch (file_type) {
 	case ITriplesBuffer::TURTLE:
@@ -32,7 +38,7 @@ SerdBuffer::SerdBuffer(std::string path, std::string base_uri, duckdb::FileSyste
 	// Assign base class FileSystem pointer and open via FileSystem to allow remote filesystems
 	this->_fs = fs;
 	try {
-		this->_file_handle = this->_fs->OpenFile(this->_file_path, duckdb::FileFlags::FILE_FLAGS_READ);
+		this->_file_handle = OpenRDFInput(*this->_fs, this->_file_path, this->_compression);
 	} catch (std::exception &ex) {
 		throw std::runtime_error("Could not open RDF file: " + this->_file_path + ": " + ex.what());
 	}
@@ -62,9 +68,15 @@ SerdBuffer::SerdBuffer(std::string path, std::string base_uri, duckdb::FileSyste
 	serd_reader_set_strict(t_reader, strict_parsing);
 	serd_reader_set_error_sink(t_reader, &ErrorCallBack, this);
 	_reader.reset(t_reader);
+
+	if (syntax == SERD_NTRIPLES || syntax == SERD_NQUADS) {
+		_tokenizer = std::unique_ptr<NTriplesTokenizer>(new NTriplesTokenizer(syntax == SERD_NQUADS));
+	}
 }
 
 SerdBuffer::~SerdBuffer() {
+	// Stop reading ahead before the readers it reads from go away
+	_read_ahead.reset();
 	if (_reader.get())
 		serd_reader_end_stream(_reader.get());
 	serd_reader_free(_reader.release());
@@ -79,70 +91,186 @@ SerdBuffer::~SerdBuffer() {
 void SerdBuffer::StartParse() {
 	const char *fp = _file_path.c_str();
 
-	// Bridge from SerdSource to DuckDB FileHandle
-	auto duckdb_source = [](void *buf, size_t size, size_t nmemb, void *stream) -> size_t {
-		// stream is a duckdb::FileHandle*
-		auto fh = static_cast<duckdb::FileHandle *>(stream);
-		if (!fh)
-			return 0;
-		int64_t read = fh->Read(buf, (idx_t)nmemb);
-		return (size_t)std::max<int64_t>(read, 0);
+	// A local NTriples/NQuads file is tokenized in place, straight from the page cache
+	if (_tokenizer && _memory_map && _compression == RDFCompression::NONE && _file_handle->OnDiskFile()) {
+		_mapping = MappedFile::Map(_file_path);
+	}
+	if (_mapping) {
+		if (_range_end != duckdb::DConstants::INVALID_INDEX) {
+			if (!_range_claim) {
+				_range_claim = std::make_shared<LineRangeClaim>(_range_start, _range_end);
+			}
+			_mapped_reader = std::unique_ptr<LineRangeReader>(
+			    new LineRangeReader(_mapping->Data(), _mapping->Size(), _range_start, _range_claim));
+		} else {
+			_block_data = _mapping->Data();
+			_block_end = _mapping->Size();
+			_source_done = true;
+		}
+		return;
+	}
+
+	ReadAheadBuffer::Source source;
+	if (_speculative) {
+		_chunk_reader = std::unique_ptr<SpeculativeChunkReader>(
+		    new SpeculativeChunkReader(*_file_handle, _header_end, _range_start, _range_end));
+		auto reader = _chunk_reader.get();
+		source = [reader](char *buf, idx_t len) { return reader->Read(buf, len); };
+	} else if (_range_end != duckdb::DConstants::INVALID_INDEX) {
+		// Only the lines owned by [_range_start, _range_end) are handed to the parser
+		if (_compression != RDFCompression::NONE) {
+			// The range is a run of frames, in compressed offsets
+			_frame_handle = _fs->OpenFile(_file_path, duckdb::FileFlags::FILE_FLAGS_READ);
+			_range_reader = std::unique_ptr<LineSource>(
+			    new FrameRangeReader(*_frame_handle, _compression, _range_start, _range_end));
+		} else {
+			if (!_range_claim) {
+				_range_claim = std::make_shared<LineRangeClaim>(_range_start, _range_end);
+			}
+			_range_reader =
+			    std::unique_ptr<LineSource>(new LineRangeReader(*_file_handle, _range_start, _range_claim));
+		}
+		auto reader = _range_reader.get();
+		source = [reader](char *buf, idx_t len) { return reader->Read(buf, len); };
+	} else {
+		_input_reader = std::unique_ptr<RDFInputReader>(new RDFInputReader(*_file_handle, _compression));
+		auto reader = _input_reader.get();
+		source = [reader](char *buf, idx_t len) { return reader->Read(buf, len); };
+	}
+	_read_ahead = std::unique_ptr<ReadAheadBuffer>(new ReadAheadBuffer(std::move(source), _buffer_size));
+
+	if (_tokenizer) {
+		_block.resize(NTRIPLES_BLOCK_SIZE);
+		_block_data = _block.data();
+		return;
+	}
+	// Bridge from SerdSource to the read-ahead buffer
+	auto read_ahead_source = [](void *buf, size_t size, size_t nmemb, void *stream) -> size_t {
+		return (size_t) static_cast<ReadAheadBuffer *>(stream)->Read((char *)buf, (idx_t)nmemb);
 	};
-	auto duckdb_error = [](void * /*stream*/) -> int {
+	auto read_ahead_error = [](void * /*stream*/) -> int {
 		return 0;
 	};
+	serd_reader_start_source_stream(_reader.get(), (SerdSource)read_ahead_source, (SerdStreamErrorFunc)read_ahead_error,
+	                                _read_ahead.get(), (uint8_t *)fp, SERD_PAGE_SIZE);
+}
 
-	serd_reader_start_source_stream(_reader.get(), (SerdSource)duckdb_source, (SerdStreamErrorFunc)duckdb_error,
-	                                _file_handle.get(), (uint8_t *)fp, 4096U);
+void SerdBuffer::SetSpeculativeChunk(idx_t header_end, idx_t chunk_idx, bool last_chunk, idx_t skip_statements) {
+	_speculative = true;
+	_header_end = header_end;
+	_last_chunk = last_chunk;
+	_skip_statements = skip_statements;
+	if (chunk_idx > 0) {
+		_genid_tag = "b" + std::to_string(chunk_idx) + "_";
+	}
 }
 
-void SerdBuffer::WriteToVector(duckdb::Vector &vec, idx_t row_idx, const SerdNode *node) {
-	if (!node || !node->buf) {
-		duckdb::FlatVector::SetNull(vec, row_idx, true);
+// serd generates blank node ids of the form b<digits>; document labels of that form are renamed to B<digits>
+bool SerdBuffer::IsGeneratedBlankId(const SerdNode *node) const {
+	if (node->type != SERD_BLANK || node->n_bytes < 2 || node->buf[0] != 'b') {
+		return false;
+	}
+	for (size_t i = 1; i < node->n_bytes; i++) {
+		if (node->buf[i] < '0' || node->buf[i] > '9') {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SerdBuffer::WriteNode(const RowTarget &target, idx_t col, const SerdNode *node) {
+	if (_output_slot[col] < 0) {
 		return;
 	}
-	// Zero-copy from Serd buffer to DuckDB String Heap
-	if (_expand_prefixes && node->type == SERD_CURIE) {
-		SerdNode expanded = serd_env_expand_node(_env.get(), node);
-		if (expanded.buf) {
-			auto str = duckdb::StringVector::AddString(vec, (const char *)expanded.buf, expanded.n_bytes);
-			duckdb::FlatVector::GetData<duckdb::string_t>(vec)[row_idx] = str;
-			serd_node_free(&expanded);
-			return;
+	idx_t len = 0;
+	const char *data = TermBytes(col, node, len, _term_scratch);
+	WriteTerm(target, col, data, len);
+}
+
+const char *SerdBuffer::TermBytes(idx_t col, const SerdNode *node, idx_t &len, std::string &scratch) {
+	if (!node || !node->buf) {
+		return nullptr;
+	}
+	if (!_genid_tag.empty() && IsGeneratedBlankId(node)) {
+		scratch = _genid_tag;
+		scratch.append((const char *)node->buf + 1, node->n_bytes - 1);
+	} else if ((_expand_prefixes || _compactor) && node->type == SERD_CURIE) {
+		SerdChunk prefix, suffix;
+		if (serd_env_expand(_env.get(), node, &prefix, &suffix) != SERD_SUCCESS) {
+			len = node->n_bytes;
+			return (const char *)node->buf;
+		}
+		scratch.assign((const char *)prefix.buf, prefix.len);
+		scratch.append((const char *)suffix.buf, suffix.len);
+		if (_compactor) {
+			// Compacted again with the prefixes of the scan, which win over the file's
+			len = scratch.size();
+			return CompactIRI(col, scratch.data(), len);
+		}
+	} else if (_compactor && node->type == SERD_URI) {
+		len = node->n_bytes;
+		return CompactIRI(col, (const char *)node->buf, len);
+	} else {
+		len = node->n_bytes;
+		return (const char *)node->buf;
+	}
+	len = scratch.size();
+	return scratch.data();
+}
+
+// Datatypes written as CURIEs are expanded for classification, whether or not prefix_expansion is on
+RDFObjectKind SerdBuffer::ObjectKind(const SerdNode *datatype) {
+	if (!datatype || !datatype->buf) {
+		return RDFObjectKind::NONE;
+	}
+	if (datatype->type == SERD_CURIE) {
+		SerdChunk prefix, suffix;
+		if (serd_env_expand(_env.get(), datatype, &prefix, &suffix) != SERD_SUCCESS) {
+			return RDFObjectKind::NONE;
+		}
+		_datatype_scratch.assign((const char *)prefix.buf, prefix.len);
+		_datatype_scratch.append((const char *)suffix.buf, suffix.len);
+		return ClassifyDatatype(_datatype_scratch.data(), _datatype_scratch.size());
+	}
+	return ClassifyDatatype((const char *)datatype->buf, datatype->n_bytes);
+}
+
+bool SerdBuffer::PassesFilter(const SerdNode *const terms[6]) {
+	if (_filter) {
+		for (idx_t col = 0; col < 6; col++) {
+			if (!_filter->HasFilter(col)) {
+				continue;
+			}
+			idx_t len = 0;
+			const char *data = TermBytes(col, terms[col], len, _term_scratch);
+			if (!_filter->Matches(col, data, len)) {
+				return false;
+			}
 		}
-		// If expansion failed, fall through to adding the original CURIE
 	}
-	auto str = duckdb::StringVector::AddString(vec, (const char *)node->buf, node->n_bytes);
-	duckdb::FlatVector::GetData<duckdb::string_t>(vec)[row_idx] = str;
+	return true;
 }
 
 void SerdBuffer::PopulateChunk(duckdb::DataChunk &output) {
 	_current_chunk = &output;
 	_current_count = 0;
-
-	// 1. Drain overflow buffer first (if any)
-	while (!_overflow_buffer.empty() && _current_count < STANDARD_VECTOR_SIZE) {
-		RDFRow row = _overflow_buffer.front();
-		_overflow_buffer.pop_front();
-		// Manual copy from string to vector (slow path)
-		if (_output_slot[0] >= 0)
-			output.SetValue(_output_slot[0], _current_count, duckdb::Value(row.graph));
-		if (_output_slot[1] >= 0)
-			output.SetValue(_output_slot[1], _current_count, duckdb::Value(row.subject));
-		if (_output_slot[2] >= 0)
-			output.SetValue(_output_slot[2], _current_count, duckdb::Value(row.predicate));
-		if (_output_slot[3] >= 0)
-			output.SetValue(_output_slot[3], _current_count, duckdb::Value(row.object));
-		if (_output_slot[4] >= 0)
-			output.SetValue(_output_slot[4], _current_count, duckdb::Value(row.datatype));
-		if (_output_slot[5] >= 0)
-			output.SetValue(_output_slot[5], _current_count, duckdb::Value(row.lang));
-		_current_count++;
+	if (_filter) {
+		_filter->Refresh();
 	}
 
+	// 1. Rows staged while the previous chunk was full come first
+	bool can_parse = TakeStagedRows(output);
+
 	// 2. Parse from file directly into Chunk
-	while (_current_count < STANDARD_VECTOR_SIZE && !_eof) {
+	if (_tokenizer && can_parse) {
+		ParseLines();
+	}
+	while (!_tokenizer && can_parse && _current_count < STANDARD_VECTOR_SIZE && !_eof) {
 		SerdStatus st = serd_reader_read_chunk(_reader.get());
+		if (_speculative && st != SERD_SUCCESS) {
+			EndSpeculativeChunk(st);
+			break;
+		}
 		switch (st) {
 		case SERD_SUCCESS:
 			// Loop continues; Callback increments current_count
@@ -151,27 +279,15 @@ void SerdBuffer::PopulateChunk(duckdb::DataChunk &output) {
 
 		case SERD_FAILURE:
 			serd_reader_end_stream(_reader.get());
-			// Determine EOF by comparing file position to file size
-			try {
-				idx_t pos = _file_handle->SeekPosition();
-				int64_t sz = _fs->GetFileSize(*_file_handle);
-				if (sz >= 0 && pos >= (idx_t)sz) {
-					_eof = true;
-				} else {
-					if (_has_error) {
-						throw duckdb::SyntaxException(_error_message);
-					} else {
-						throw std::runtime_error("SERD failure");
-					}
-				}
-			} catch (std::exception &ex) {
-				if (_has_error) {
-					throw duckdb::SyntaxException(_error_message);
-				} else {
-					throw std::runtime_error(std::string("SERD failure: ") + ex.what());
-				}
+			// The parse is done once the last byte of its input has been handed to serd
+			if (_read_ahead->Finished()) {
+				_eof = true;
+				break;
 			}
-			break;
+			if (_has_error) {
+				throw duckdb::SyntaxException(_error_message);
+			}
+			throw std::runtime_error("SERD failure");
 		case SERD_ERR_BAD_CURIE:
 		case SERD_ERR_ID_CLASH:
 		case SERD_ERR_BAD_TEXT:
@@ -194,26 +310,125 @@ void SerdBuffer::PopulateChunk(duckdb::DataChunk &output) {
 		}
 	}
 
-	output.SetCardinality(_current_count);
+	FinishChunk(output);
 	_current_chunk = nullptr; // Clear pointer for safety
 }
 
-string SerdBuffer::SafeString(const SerdNode *node) {
-	if (!node || !node->buf || node->n_bytes == 0)
-		return {};
-	std::string retVal;
-	if (_expand_prefixes && node->type == SERD_CURIE) {
-		SerdNode expanded = serd_env_expand_node(_env.get(), node);
-		if (expanded.buf) {
-			retVal = std::string(reinterpret_cast<const char *>(expanded.buf), expanded.n_bytes);
-			serd_node_free(&expanded);
-		} else {
-			retVal = std::string(reinterpret_cast<const char *>(node->buf), node->n_bytes);
+void SerdBuffer::ParseLines() {
+	NTriplesStatement stmt;
+	bool count_only = CountOnly();
+	while (_current_count < STANDARD_VECTOR_SIZE) {
+		auto line = _block_data + _block_pos;
+		auto block_end = _block_data + _block_end;
+		bool plain = true;
+		auto line_end = NTriplesTokenizer::FindLineEnd(line, block_end, plain);
+		if (line_end == block_end && !_source_done) {
+			FillBlock();
+			continue;
+		}
+		if (line == block_end) {
+			_eof = true;
+			return;
+		}
+		_block_pos = (idx_t)(line_end - _block_data) + (line_end < block_end ? 1 : 0);
+		_line_number++;
+		auto result = plain ? _tokenizer->Tokenize(line, line_end, stmt) : NTriplesTokenizer::Result::FALLBACK;
+		if (result == NTriplesTokenizer::Result::STATEMENT) {
+			// The tokenizer has checked the line, so a count needs nothing more from it
+			if (SkipSample()) {
+				continue;
+			} else if (count_only) {
+				_current_count++;
+			} else {
+				AddStatement(stmt);
+			}
+		} else if (result == NTriplesTokenizer::Result::FALLBACK) {
+			ParseLineWithSerd(line, line_end);
+		}
+	}
+}
+
+// Moves the incomplete last line to the front of the block and reads more after it
+void SerdBuffer::FillBlock() {
+	if (_mapped_reader) {
+		// The range's lines are adjacent in the mapping, so the block just grows over them
+		idx_t length;
+		auto data = _mapped_reader->ReadMapped(NTRIPLES_BLOCK_SIZE, length);
+		if (!data) {
+			_source_done = true;
+			return;
+		}
+		if (!_block_data) {
+			_block_data = data;
+		}
+		D_ASSERT(data == _block_data + _block_end);
+		_block_end += length;
+		return;
+	}
+	idx_t kept = _block_end - _block_pos;
+	if (kept > 0 && _block_pos > 0) {
+		memmove(_block.data(), _block.data() + _block_pos, kept);
+	}
+	_block_pos = 0;
+	_block_end = kept;
+	if (kept == _block.size()) {
+		// A single line longer than the block
+		_block.resize(_block.size() * 2);
+		_block_data = _block.data();
+	}
+	idx_t read = _read_ahead->Read(_block.data() + kept, _block.size() - kept);
+	_source_done = read == 0;
+	_block_end += read;
+}
+
+// Escapes, non-ASCII text and malformed lines go through serd, which also raises the errors
+void SerdBuffer::ParseLineWithSerd(const char *line, const char *line_end) {
+	_fallback_line.assign(line, (size_t)(line_end - line));
+	SerdStatus st = serd_reader_read_string(_reader.get(), (const uint8_t *)_fallback_line.c_str());
+	if (_has_error) {
+		throw duckdb::SyntaxException(_error_message);
+	}
+	if (st > SERD_FAILURE && _strict_parsing) {
+		throw duckdb::SyntaxException("SERD Error: " + SerdStatusToString(st));
+	}
+}
+
+void SerdBuffer::AddStatement(NTriplesStatement &stmt) {
+	auto kind = stmt.literal ? ClassifyDatatype(stmt.data[4], stmt.len[4]) : RDFObjectKind::NONE;
+	if (_compactor) {
+		for (idx_t col = 0; col < 5; col++) {
+			if (stmt.iri[col]) {
+				stmt.data[col] = CompactIRI(col, stmt.data[col], stmt.len[col]);
+			}
+		}
+	}
+	if (_filter) {
+		for (idx_t col = 0; col < 6; col++) {
+			if (_filter->HasFilter(col) && !_filter->Matches(col, stmt.data[col], stmt.len[col])) {
+				return;
+			}
 		}
-	} else {
-		retVal = std::string(reinterpret_cast<const char *>(node->buf), node->n_bytes);
 	}
-	return retVal;
+	auto target = BeginRow();
+	for (idx_t col = 0; col < 6; col++) {
+		WriteTerm(target, col, stmt.data[col], stmt.len[col]);
+	}
+	WriteTypedObject(target, kind, stmt.data[3], stmt.len[3]);
+	EndRow(target);
+}
+
+void SerdBuffer::EndSpeculativeChunk(SerdStatus st) {
+	serd_reader_end_stream(_reader.get());
+	_eof = true;
+	if (st == SERD_FAILURE && !_has_error && !_error_at_end) {
+		return; // the chunk ended on a statement boundary
+	}
+	if (!_last_chunk && _read_ahead->Finished()) {
+		// serd ran out of bytes mid-statement: the boundary after this chunk was guessed wrong
+		_truncated = true;
+		return;
+	}
+	_deferred_error = _has_error ? _error_message : "SERD Error: " + SerdStatusToString(st);
 }
 
 string SerdBuffer::SerdStatusToString(SerdStatus status) {
@@ -250,36 +465,33 @@ SerdStatus SerdBuffer::StatementCallback(void *user_data, SerdStatementFlags, co
                                          const SerdNode *object_datatype, const SerdNode *object_lang) {
 	auto *self = static_cast<SerdBuffer *>(user_data);
 
-	// Safety check: If chunk is full, push to overflow and return
-	if (self->_current_count >= STANDARD_VECTOR_SIZE) {
-		RDFRow row;
-		row.subject = self->SafeString(subject);
-		row.predicate = self->SafeString(predicate);
-		row.object = self->SafeString(object);
-		row.graph = self->SafeString(graph);
-		row.datatype = self->SafeString(object_datatype);
-		row.lang = self->SafeString(object_lang);
-		self->_overflow_buffer.push_back(std::move(row));
+	// A re-parsed speculative chunk skips the statements it produced before
+	if (++self->_statement_count <= self->_skip_statements) {
+		return SERD_SUCCESS;
+	}
+	if (self->SkipSample()) {
+		return SERD_SUCCESS;
+	}
+	if (self->CountOnly()) {
+		self->CountRow();
+		return SERD_SUCCESS;
+	}
+
+	// In column order: 0:graph, 1:subject, 2:predicate, 3:object, ...
+	const SerdNode *const terms[6] = {graph, subject, predicate, object, object_datatype, object_lang};
+	if (!self->PassesFilter(terms)) {
 		return SERD_SUCCESS;
 	}
 
-	// Fast Path: Direct Write to DuckDB Vectors
-	// Note: DataChunk columns map to: 0:graph, 1:subject, 2:predicate, 3:object, ...
-	const int8_t *slots = self->_output_slot;
-	if (slots[0] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[0]], self->_current_count, graph);
-	if (slots[1] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[1]], self->_current_count, subject);
-	if (slots[2] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[2]], self->_current_count, predicate);
-	if (slots[3] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[3]], self->_current_count, object);
-	if (slots[4] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[4]], self->_current_count, object_datatype);
-	if (slots[5] >= 0)
-		self->WriteToVector(self->_current_chunk->data[slots[5]], self->_current_count, object_lang);
-
-	self->_current_count++;
+	// Direct write to DuckDB vectors, or to a staging chunk once the output is full
+	auto target = self->BeginRow();
+	for (idx_t col = 0; col < 6; col++) {
+		self->WriteNode(target, col, terms[col]);
+	}
+	if (target.typed && object->type == SERD_LITERAL) {
+		self->WriteTypedObject(target, self->ObjectKind(object_datatype), (const char *)object->buf, object->n_bytes);
+	}
+	self->EndRow(target);
 	return SERD_SUCCESS;
 }
 
@@ -287,26 +499,69 @@ SerdStatus SerdBuffer::StatementCallback(void *user_data, SerdStatementFlags, co
 // it doesn't seem like calling it actually helps.
 SerdStatus SerdBuffer::ErrorCallBack(void *user_data, const SerdError *error) {
 	auto *self = static_cast<SerdBuffer *>(user_data);
+	if (self->_chunk_reader && self->_read_ahead->Finished()) {
+		self->_error_at_end = true;
+	}
 	if (self->_strict_parsing) {
 		self->_has_error = true;
+		if (self->_speculative && self->_range_start > 0) {
+			// serd counts the replayed directives ahead of the chunk's own lines
+			auto line = error->line - self->_chunk_reader->HeaderLines();
+			self->_error_message = "SERD parsing error '" + SerdStatusToString(error->status) + "', at line " +
+			                       std::to_string(line) + " of the chunk starting at offset " +
+			                       std::to_string(self->_range_start);
+			return SERD_FAILURE;
+		}
+		// The fast path hands serd one line at a time
+		auto line = self->_tokenizer ? self->_line_number : (idx_t)error->line;
 		self->_error_message =
-		    "SERD parsing error '" + SerdStatusToString(error->status) + "', at line " + std::to_string(error->line);
+		    "SERD parsing error '" + SerdStatusToString(error->status) + "', at line " + std::to_string(line);
+		if (self->_range_start > 0) {
+			// serd counts lines from the start of the range it was handed
+			self->_error_message += " of the byte range starting at offset " + std::to_string(self->_range_start);
+		}
 		return SERD_FAILURE;
 	} else
 		return SERD_SUCCESS;
 }
 
+static SerdStatus CountBase(void *user_data, const SerdNode *) {
+	(*static_cast<idx_t *>(user_data))++;
+	return SERD_SUCCESS;
+}
+
+static SerdStatus CountPrefix(void *user_data, const SerdNode *, const SerdNode *) {
+	(*static_cast<idx_t *>(user_data))++;
+	return SERD_SUCCESS;
+}
+
+idx_t SerdBuffer::CountDirectives(const std::string &text) {
+	idx_t count = 0;
+	std::unique_ptr<SerdReader, decltype(&serd_reader_free)> reader(
+	    serd_reader_new(SERD_TURTLE, &count, nullptr, &CountBase, &CountPrefix, nullptr, nullptr), &serd_reader_free);
+	if (!reader) {
+		throw std::runtime_error("Unable to create a serd reader for parsing");
+	}
+	serd_reader_read_string(reader.get(), (const uint8_t *)text.c_str());
+	return count;
+}
+
 SerdStatus SerdBuffer::BaseCallback(void *user_data, const SerdNode *uri) {
 	auto *self = static_cast<SerdBuffer *>(user_data);
+	self->_directive_count++;
 	serd_env_set_base_uri(self->_env.get(), uri);
 	return SERD_SUCCESS;
 }
 
 SerdStatus SerdBuffer::PrefixCallback(void *user_data, const SerdNode *name, const SerdNode *uri) {
 	auto *self = static_cast<SerdBuffer *>(user_data);
-	if (self->_expand_prefixes) {
-		// Update SerdEnv with new prefix mapping
-		serd_env_set_prefix(self->_env.get(), name, uri);
+	self->_directive_count++;
+	// Update SerdEnv with new prefix mapping; CURIE datatypes are expanded with it even without
+	// prefix_expansion
+	serd_env_set_prefix(self->_env.get(), name, uri);
+	if (self->_compactor) {
+		self->AddFilePrefix(std::string((const char *)name->buf, name->n_bytes),
+		                    std::string((const char *)uri->buf, uri->n_bytes));
 	}
 	return SERD_SUCCESS;
 }
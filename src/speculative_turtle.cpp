@@ -0,0 +1,314 @@
+#include "include/speculative_turtle.hpp"
+#include "duckdb/common/exception.hpp"
+#include <cstring>
+
+using duckdb::idx_t;
+
+// Bytes examined after a nominal split point when looking for a statement boundary
+static constexpr idx_t BOUNDARY_WINDOW = 256 * 1024;
+// Bytes examined for the leading directives
+static constexpr idx_t HEADER_WINDOW = 64 * 1024;
+
+static bool IsBlank(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Returns the last character of a line outside strings, IRIs and comments. Returns '\0' for a
+// blank line or one that ends inside a string or IRI, which can't be judged on its own.
+static char LastSignificantChar(const char *line, idx_t len) {
+	char last = '\0';
+	idx_t i = 0;
+	while (i < len) {
+		char c = line[i];
+		if (c == '#') {
+			break;
+		}
+		if (c == '<') {
+			auto close = static_cast<const char *>(memchr(line + i + 1, '>', len - i - 1));
+			if (!close) {
+				return '\0';
+			}
+			i = (idx_t)(close - line) + 1;
+			last = '>';
+			continue;
+		}
+		if (c == '"' || c == '\'') {
+			bool long_string = i + 2 < len && line[i + 1] == c && line[i + 2] == c;
+			idx_t j = i + (long_string ? 3 : 1);
+			bool closed = false;
+			while (j < len) {
+				if (line[j] == '\\') {
+					j += 2;
+					continue;
+				}
+				if (line[j] == c && (!long_string || (j + 2 < len && line[j + 1] == c && line[j + 2] == c))) {
+					j += long_string ? 3 : 1;
+					closed = true;
+					break;
+				}
+				j++;
+			}
+			if (!closed) {
+				return '\0';
+			}
+			i = j;
+			last = c;
+			continue;
+		}
+		if (!IsBlank(c)) {
+			last = c;
+		}
+		i++;
+	}
+	return last;
+}
+
+static bool StartsWithKeyword(const char *line, idx_t len, const char *keyword, bool case_sensitive) {
+	idx_t n = strlen(keyword);
+	if (len <= n || !(IsBlank(line[n]) || line[n] == '<')) {
+		return false;
+	}
+	for (idx_t i = 0; i < n; i++) {
+		char c = case_sensitive ? line[i] : (char)toupper(line[i]);
+		if (c != keyword[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static idx_t ReadWindow(duckdb::FileHandle &handle, idx_t offset, idx_t size, idx_t file_size, std::string &buf) {
+	idx_t n = duckdb::MinValue<idx_t>(size, file_size - offset);
+	buf.resize(n);
+	if (n > 0) {
+		handle.Read(&buf[0], n, offset);
+	}
+	return n;
+}
+
+idx_t ScanTurtleHeader(duckdb::FileHandle &handle, idx_t file_size) {
+	std::string buf;
+	idx_t n = ReadWindow(handle, 0, HEADER_WINDOW, file_size, buf);
+	const char *data = buf.data();
+	idx_t header_end = 0;
+	idx_t line_start = 0;
+	while (line_start < n) {
+		auto nl = static_cast<const char *>(memchr(data + line_start, '\n', n - line_start));
+		if (!nl) {
+			break;
+		}
+		idx_t line_end = (idx_t)(nl - data);
+		const char *line = data + line_start;
+		idx_t len = line_end - line_start;
+		while (len > 0 && IsBlank(*line)) {
+			line++;
+			len--;
+		}
+		if (len > 0 && *line != '#') {
+			// Only directives that end on their own line are replayed
+			char last = LastSignificantChar(line, len);
+			bool turtle_directive =
+			    StartsWithKeyword(line, len, "@prefix", true) || StartsWithKeyword(line, len, "@base", true);
+			bool sparql_directive =
+			    StartsWithKeyword(line, len, "PREFIX", false) || StartsWithKeyword(line, len, "BASE", false);
+			if (!((turtle_directive && last == '.') || (sparql_directive && last == '>'))) {
+				break;
+			}
+		}
+		line_start = line_end + 1;
+		header_end = line_start;
+	}
+	return header_end;
+}
+
+// Looks for the first guessed statement boundary in the window read at offset
+static idx_t FindBoundary(const std::string &buf, idx_t offset) {
+	const char *data = buf.data();
+	idx_t n = buf.size();
+	// The line holding the window's first byte may have started before it
+	auto first_nl = static_cast<const char *>(memchr(data, '\n', n));
+	if (!first_nl) {
+		return duckdb::DConstants::INVALID_INDEX;
+	}
+	idx_t line_start = (idx_t)(first_nl - data) + 1;
+	bool after_statement = false;
+	idx_t candidate = 0;
+	while (line_start < n) {
+		auto nl = static_cast<const char *>(memchr(data + line_start, '\n', n - line_start));
+		if (!nl) {
+			break;
+		}
+		idx_t line_end = (idx_t)(nl - data);
+		const char *line = data + line_start;
+		idx_t len = line_end - line_start;
+		idx_t indent = 0;
+		while (indent < len && IsBlank(line[indent])) {
+			indent++;
+		}
+		if (after_statement && indent < len && line[indent] != '#') {
+			// Statements are rarely written with a leading indent; the contents of TriG graphs
+			// and continuation lines usually are
+			if (indent == 0) {
+				return offset + candidate;
+			}
+			after_statement = false;
+		}
+		char last = LastSignificantChar(line, len);
+		if (last == '.' || last == '}') {
+			after_statement = true;
+			candidate = line_end + 1;
+		}
+		line_start = line_end + 1;
+	}
+	return duckdb::DConstants::INVALID_INDEX;
+}
+
+std::vector<idx_t> GuessTurtleBoundaries(duckdb::FileHandle &handle, idx_t header_end, idx_t file_size,
+                                         idx_t chunk_size) {
+	std::vector<idx_t> boundaries {0};
+	std::string buf;
+	for (idx_t nominal = header_end + chunk_size; nominal < file_size; nominal += chunk_size) {
+		if (nominal <= boundaries.back()) {
+			continue;
+		}
+		ReadWindow(handle, nominal, BOUNDARY_WINDOW, file_size, buf);
+		idx_t boundary = FindBoundary(buf, nominal);
+		if (boundary != duckdb::DConstants::INVALID_INDEX && boundary < file_size) {
+			boundaries.push_back(boundary);
+		}
+	}
+	boundaries.push_back(file_size);
+	return boundaries;
+}
+
+SpeculativeChunkReader::SpeculativeChunkReader(duckdb::FileHandle &handle, idx_t header_end, idx_t start, idx_t end)
+    : _handle(handle), _header_end(start > 0 ? header_end : 0), _end(end), _position(start) {
+}
+
+idx_t SpeculativeChunkReader::Read(char *buf, idx_t len) {
+	// Fill the whole page: serd takes a short read for the end of the stream
+	idx_t filled = 0;
+	if (_header_position < _header_end) {
+		idx_t n = duckdb::MinValue<idx_t>(len, _header_end - _header_position);
+		_handle.Read(buf, n, _header_position);
+		for (idx_t i = 0; i < n; i++) {
+			_header_lines += buf[i] == '\n';
+		}
+		_header_position += n;
+		filled += n;
+	}
+	if (filled < len && _position < _end) {
+		idx_t n = duckdb::MinValue<idx_t>(len - filled, _end - _position);
+		_handle.Read(buf + filled, n, _position);
+		_position += n;
+		filled += n;
+	}
+	return filled;
+}
+
+SpeculativeTurtleFile::SpeculativeTurtleFile(idx_t header_end_p, const std::vector<idx_t> &boundaries)
+    : header_end(header_end_p), file_size(boundaries.back()) {
+	for (idx_t i = 0; i + 1 < boundaries.size(); i++) {
+		SpeculativeChunk chunk;
+		chunk.start = boundaries[i];
+		chunk.end = boundaries[i + 1];
+		chunks.push_back(std::move(chunk));
+	}
+	chunks[0].confirmed = true;
+}
+
+idx_t SpeculativeTurtleFile::NextChunk(idx_t chunk_idx) const {
+	for (idx_t i = chunk_idx + 1; i < chunks.size(); i++) {
+		if (!chunks[i].absorbed) {
+			return i;
+		}
+	}
+	return duckdb::DConstants::INVALID_INDEX;
+}
+
+bool SpeculativeTurtleFile::IsLastChunk(idx_t chunk_idx) const {
+	return NextChunk(chunk_idx) == duckdb::DConstants::INVALID_INDEX;
+}
+
+void SpeculativeTurtleFile::Confirm(idx_t chunk_idx,
+                                    std::vector<duckdb::unique_ptr<duckdb::ColumnDataCollection>> &ready) {
+	auto &chunk = chunks[chunk_idx];
+	chunk.confirmed = true;
+	if (chunk.staged && chunk.staged->Count() > 0) {
+		ready.push_back(std::move(chunk.staged));
+	}
+	chunk.staged.reset();
+}
+
+void SpeculativeTurtleFile::Finish(idx_t chunk_idx, bool truncated, const std::string &error, idx_t statements,
+                                   idx_t directives,
+                                   std::vector<duckdb::unique_ptr<duckdb::ColumnDataCollection>> &ready,
+                                   std::vector<idx_t> &reparse) {
+	auto &finished = chunks[chunk_idx];
+	if (finished.absorbed) {
+		return;
+	}
+	finished.finished = true;
+	finished.truncated = truncated;
+	finished.error = truncated ? std::string() : error;
+	finished.statements = statements;
+	finished.directives = directives;
+
+	for (idx_t i = 0; i < chunks.size(); i++) {
+		auto &chunk = chunks[i];
+		if (chunk.absorbed || chunk.resolved) {
+			continue;
+		}
+		if (!chunk.confirmed || !chunk.finished) {
+			return;
+		}
+		if (!chunk.error.empty()) {
+			throw duckdb::SyntaxException(chunk.error);
+		}
+		idx_t next = NextChunk(i);
+		if (!chunk.truncated && chunk.directives > header_directives && next != duckdb::DConstants::INVALID_INDEX) {
+			// The chunk declares prefixes or a base the chunks after it did not see: parse the rest of
+			// the file with it
+			while (next != duckdb::DConstants::INVALID_INDEX) {
+				chunks[next].absorbed = true;
+				chunks[next].staged.reset();
+				chunk.end = chunks[next].end;
+				next = NextChunk(next);
+			}
+			chunk.finished = false;
+			reparse.push_back(i);
+			return;
+		}
+		if (!chunk.truncated) {
+			chunk.resolved = true;
+			if (next != duckdb::DConstants::INVALID_INDEX) {
+				Confirm(next, ready);
+			}
+			continue;
+		}
+		// The guessed boundary at chunk.end cut a statement in two, so the next chunk began
+		// inside it: drop that chunk and parse this one through its end instead. So does every
+		// chunk after it whose own parse failed, as it began inside the statement as well. At
+		// least as many chunks are added as the chunk spans, so a statement spanning k chunks is
+		// re-parsed O(log k) times rather than k.
+		D_ASSERT(next != duckdb::DConstants::INVALID_INDEX);
+		idx_t count = 0;
+		while (next != duckdb::DConstants::INVALID_INDEX) {
+			auto &absorbed = chunks[next];
+			bool bad_start = absorbed.finished && (absorbed.truncated || !absorbed.error.empty());
+			if (count > chunk.absorbed_chunks && !bad_start) {
+				break;
+			}
+			absorbed.absorbed = true;
+			absorbed.staged.reset();
+			chunk.end = absorbed.end;
+			count++;
+			next = NextChunk(next);
+		}
+		chunk.absorbed_chunks += count;
+		chunk.finished = false;
+		chunk.truncated = false;
+		reparse.push_back(i);
+		return;
+	}
+}
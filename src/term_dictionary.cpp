@@ -0,0 +1,81 @@
+#include "include/term_dictionary.hpp"
+
+using namespace duckdb;
+
+static constexpr uint32_t NO_NULL_ID = NumericLimits<uint32_t>::Maximum();
+
+TermDictionary::TermDictionary() : _null_id(NO_NULL_ID), _sel(STANDARD_VECTOR_SIZE) {
+}
+
+bool TermDictionary::Add(Vector &vec, idx_t row, const char *data, idx_t len) {
+	uint32_t id;
+	if (!data) {
+		if (_null_id == NO_NULL_ID) {
+			_null_id = (uint32_t)_terms.size();
+			_terms.push_back(string_t());
+		}
+		id = _null_id;
+	} else {
+		_all_null = false;
+		auto entry = _ids.find(string_t(data, (uint32_t)len));
+		if (entry != _ids.end()) {
+			id = entry->second;
+		} else {
+			if (_terms.size() >= MAX_TERMS) {
+				Deactivate(vec, row);
+				return false;
+			}
+			id = (uint32_t)_terms.size();
+			auto term = _heap.AddBlob(data, len);
+			_ids[term] = id;
+			_terms.push_back(term);
+		}
+	}
+	_sel.set_index(row, id);
+	return true;
+}
+
+void TermDictionary::Emit(Vector &vec, idx_t count) {
+	if (!_active || count == 0) {
+		return;
+	}
+	if (_all_null) {
+		vec.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(vec, true);
+		return;
+	}
+	if (_dictionary_size != _terms.size()) {
+		_dictionary = DictionaryVector::CreateReusableDictionary(LogicalType::VARCHAR, _terms.size());
+		_dictionary_size = _terms.size();
+		auto &dict = _dictionary->data;
+		auto strings = FlatVector::GetData<string_t>(dict);
+		for (idx_t id = 0; id < _terms.size(); id++) {
+			if (id == _null_id) {
+				FlatVector::SetNull(dict, id, true);
+			} else {
+				strings[id] = StringVector::AddString(dict, _terms[id]);
+			}
+		}
+	}
+	vec.Dictionary(_dictionary, _sel);
+	// The emitted vector keeps referencing this selection
+	_sel = SelectionVector(STANDARD_VECTOR_SIZE);
+	_all_null = true;
+}
+
+void TermDictionary::Deactivate(Vector &vec, idx_t count) {
+	auto strings = FlatVector::GetData<string_t>(vec);
+	for (idx_t row = 0; row < count; row++) {
+		auto id = _sel.get_index(row);
+		if (id == _null_id) {
+			FlatVector::SetNull(vec, row, true);
+		} else {
+			strings[row] = StringVector::AddString(vec, _terms[id]);
+		}
+	}
+	_active = false;
+	_ids.clear();
+	_terms.clear();
+	_dictionary.reset();
+	_heap.Destroy();
+}
@@ -0,0 +1,243 @@
+#include "include/term_ids.hpp"
+#include <cstring>
+
+using namespace duckdb;
+
+// Kinds of key, its first byte
+static constexpr char KEY_NODE = 0;
+static constexpr char KEY_DATATYPE = 1;
+static constexpr char KEY_LANG = 2;
+static constexpr char KEY_DATATYPE_LANG = 3;
+
+shared_ptr<RDFTermIds> RDFTermIds::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<RDFTermIds>(RDFTermIds::ObjectType());
+}
+
+static void AppendLength(std::string &key, idx_t len) {
+	uint32_t len32 = (uint32_t)len;
+	key.append((const char *)&len32, sizeof(len32));
+}
+
+static idx_t ReadLength(const char *&pos) {
+	uint32_t len32;
+	memcpy(&len32, pos, sizeof(len32));
+	pos += sizeof(len32);
+	return len32;
+}
+
+// IRIs, blank nodes and plain literals are the value alone. Otherwise the value's length comes
+// first, so no value can be mistaken for a value with a suffix.
+void RDFTermIds::MakeKey(const string_t &value, const string_t *datatype, const string_t *lang, std::string &key) {
+	key.clear();
+	if (!datatype && !lang) {
+		key.push_back(KEY_NODE);
+		key.append(value.GetData(), value.GetSize());
+		return;
+	}
+	key.push_back(datatype && lang ? KEY_DATATYPE_LANG : (datatype ? KEY_DATATYPE : KEY_LANG));
+	AppendLength(key, value.GetSize());
+	key.append(value.GetData(), value.GetSize());
+	if (datatype && lang) {
+		AppendLength(key, datatype->GetSize());
+	}
+	if (datatype) {
+		key.append(datatype->GetData(), datatype->GetSize());
+	}
+	if (lang) {
+		key.append(lang->GetData(), lang->GetSize());
+	}
+}
+
+void RDFTermIds::Lookup(const string_t *keys, idx_t count, int64_t *ids) {
+	D_ASSERT(count <= STANDARD_VECTOR_SIZE);
+	// Keys grouped by shard, in their order within each shard
+	uint8_t shard_of[STANDARD_VECTOR_SIZE];
+	uint32_t order[STANDARD_VECTOR_SIZE];
+	idx_t starts[SHARD_COUNT + 1] = {0};
+	for (idx_t i = 0; i < count; i++) {
+		shard_of[i] = (uint8_t)(Hash(keys[i].GetData(), keys[i].GetSize()) >> (64 - SHARD_BITS));
+		starts[shard_of[i] + 1]++;
+	}
+	for (idx_t s = 0; s < SHARD_COUNT; s++) {
+		starts[s + 1] += starts[s];
+	}
+	idx_t fill[SHARD_COUNT];
+	memcpy(fill, starts, sizeof(fill));
+	for (idx_t i = 0; i < count; i++) {
+		order[fill[shard_of[i]]++] = (uint32_t)i;
+	}
+
+	for (idx_t s = 0; s < SHARD_COUNT; s++) {
+		if (starts[s] == starts[s + 1]) {
+			continue;
+		}
+		auto &shard = _shards[s];
+		std::lock_guard<std::mutex> lk(shard.lock);
+		for (idx_t k = starts[s]; k < starts[s + 1]; k++) {
+			auto i = order[k];
+			auto entry = shard.ids.find(keys[i]);
+			if (entry != shard.ids.end()) {
+				ids[i] = entry->second;
+				continue;
+			}
+			auto id = (int64_t)((shard.keys.size() << SHARD_BITS) | s);
+			auto key = shard.heap.AddBlob(keys[i].GetData(), keys[i].GetSize());
+			shard.ids[key] = id;
+			shard.keys.push_back(key);
+			ids[i] = id;
+		}
+	}
+}
+
+idx_t RDFTermIds::Scan(idx_t shard_idx, idx_t pos, DataChunk &output) {
+	auto &shard = _shards[shard_idx];
+	std::lock_guard<std::mutex> lk(shard.lock);
+	auto start = output.size();
+	auto available = shard.keys.size() - MinValue<idx_t>(pos, shard.keys.size());
+	auto count = MinValue<idx_t>(available, STANDARD_VECTOR_SIZE - start);
+	auto ids = FlatVector::GetData<int64_t>(output.data[0]);
+	auto values = FlatVector::GetData<string_t>(output.data[1]);
+	auto datatypes = FlatVector::GetData<string_t>(output.data[2]);
+	auto langs = FlatVector::GetData<string_t>(output.data[3]);
+	for (idx_t i = 0; i < count; i++) {
+		auto row = start + i;
+		auto &key = shard.keys[pos + i];
+		ids[row] = (int64_t)(((pos + i) << SHARD_BITS) | shard_idx);
+		const char *data = key.GetData();
+		const char *end = data + key.GetSize();
+		auto kind = *data++;
+		if (kind == KEY_NODE) {
+			values[row] = StringVector::AddString(output.data[1], data, end - data);
+			FlatVector::SetNull(output.data[2], row, true);
+			FlatVector::SetNull(output.data[3], row, true);
+			continue;
+		}
+		auto value_len = ReadLength(data);
+		values[row] = StringVector::AddString(output.data[1], data, value_len);
+		data += value_len;
+		auto datatype_len = kind == KEY_DATATYPE_LANG ? ReadLength(data) : (idx_t)(end - data);
+		if (kind == KEY_LANG) {
+			FlatVector::SetNull(output.data[2], row, true);
+		} else {
+			datatypes[row] = StringVector::AddString(output.data[2], data, datatype_len);
+			data += datatype_len;
+		}
+		if (kind == KEY_DATATYPE) {
+			FlatVector::SetNull(output.data[3], row, true);
+		} else {
+			langs[row] = StringVector::AddString(output.data[3], data, end - data);
+		}
+	}
+	return count;
+}
+
+RDFTermEncoder::RDFTermEncoder(shared_ptr<RDFTermIds> ids, const vector<column_t> &column_ids)
+    : _ids(std::move(ids)), _term_column_ids(column_ids) {
+	bool object = false;
+	for (idx_t i = 0; i < column_ids.size(); i++) {
+		object |= column_ids[i] == 3;
+		if (column_ids[i] == 4) {
+			_datatype_slot = (int)i;
+		} else if (column_ids[i] == 5) {
+			_lang_slot = (int)i;
+		}
+	}
+	if (object && _datatype_slot < 0) {
+		_datatype_slot = (int)_term_column_ids.size();
+		_term_column_ids.push_back(4);
+	}
+	if (object && _lang_slot < 0) {
+		_lang_slot = (int)_term_column_ids.size();
+		_term_column_ids.push_back(5);
+	}
+}
+
+vector<LogicalType> RDFTermEncoder::TermTypes(const vector<LogicalType> &output_types) const {
+	vector<LogicalType> types;
+	for (idx_t i = 0; i < _term_column_ids.size(); i++) {
+		if (i >= output_types.size() || IsEncodedColumn(_term_column_ids[i])) {
+			types.push_back(LogicalType::VARCHAR);
+		} else {
+			types.push_back(output_types[i]);
+		}
+	}
+	return types;
+}
+
+void RDFTermEncoder::Encode(DataChunk &terms, DataChunk &output) {
+	for (idx_t i = 0; i < output.ColumnCount(); i++) {
+		if (IsEncodedColumn(_term_column_ids[i])) {
+			EncodeColumn(terms, i, output.data[i]);
+		} else {
+			output.data[i].Reference(terms.data[i]);
+		}
+	}
+	output.SetCardinality(terms.size());
+}
+
+void RDFTermEncoder::EncodeColumn(DataChunk &terms, idx_t slot, Vector &result) {
+	auto count = terms.size();
+	auto col = _term_column_ids[slot];
+	UnifiedVectorFormat values, datatypes, langs;
+	terms.data[slot].ToUnifiedFormat(count, values);
+	bool object = col == 3;
+	if (object) {
+		terms.data[_datatype_slot].ToUnifiedFormat(count, datatypes);
+		terms.data[_lang_slot].ToUnifiedFormat(count, langs);
+	}
+	auto value_data = UnifiedVectorFormat::GetData<string_t>(values);
+	auto datatype_data = object ? UnifiedVectorFormat::GetData<string_t>(datatypes) : nullptr;
+	auto lang_data = object ? UnifiedVectorFormat::GetData<string_t>(langs) : nullptr;
+
+	// Collect the keys of the rows, a run of one key only once
+	auto &last = _last[col];
+	idx_t last_key = DConstants::INVALID_INDEX;
+	_key_data.clear();
+	_key_ends.clear();
+	_row_keys.resize(count);
+	auto &validity = FlatVector::Validity(result);
+	for (idx_t row = 0; row < count; row++) {
+		auto idx = values.sel->get_index(row);
+		if (!values.validity.RowIsValid(idx)) {
+			validity.SetInvalid(row);
+			continue;
+		}
+		const string_t *datatype = nullptr;
+		const string_t *lang = nullptr;
+		if (object) {
+			auto datatype_idx = datatypes.sel->get_index(row);
+			auto lang_idx = langs.sel->get_index(row);
+			datatype = datatypes.validity.RowIsValid(datatype_idx) ? &datatype_data[datatype_idx] : nullptr;
+			lang = langs.validity.RowIsValid(lang_idx) ? &lang_data[lang_idx] : nullptr;
+		}
+		RDFTermIds::MakeKey(value_data[idx], datatype, lang, _key);
+		if (!last.valid || _key != last.key) {
+			_key_data += _key;
+			_key_ends.push_back(_key_data.size());
+			last_key = _key_ends.size() - 1;
+			last.key = _key;
+			last.valid = true;
+		}
+		_row_keys[row] = last_key;
+	}
+
+	_keys.resize(_key_ends.size());
+	_key_ids.resize(_key_ends.size());
+	for (idx_t k = 0; k < _key_ends.size(); k++) {
+		auto start = k == 0 ? 0 : _key_ends[k - 1];
+		_keys[k] = string_t(_key_data.data() + start, (uint32_t)(_key_ends[k] - start));
+	}
+	if (!_keys.empty()) {
+		_ids->Lookup(_keys.data(), _keys.size(), _key_ids.data());
+	}
+
+	auto ids = FlatVector::GetData<int64_t>(result);
+	for (idx_t row = 0; row < count; row++) {
+		if (validity.RowIsValid(row)) {
+			ids[row] = _row_keys[row] == DConstants::INVALID_INDEX ? last.id : _key_ids[_row_keys[row]];
+		}
+	}
+	if (last_key != DConstants::INVALID_INDEX) {
+		last.id = _key_ids[last_key];
+	}
+}
@@ -0,0 +1,179 @@
+#include "include/I_triples_buffer.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include <cstring>
+
+using namespace duckdb;
+
+ITriplesBuffer::RowTarget ITriplesBuffer::BeginRow() {
+	if (_current_count < STANDARD_VECTOR_SIZE) {
+		return RowTarget {_current_chunk, _current_count, false, _typed.get()};
+	}
+	// A single parser step can produce any number of statements (a Turtle subject with many
+	// objects, a large collection), so rows past the end of the output are staged column by column
+	if (_staging.chunk && _staging.chunk->size() >= STANDARD_VECTOR_SIZE) {
+		SpillStaging();
+	}
+	if (!_staging.chunk) {
+		_staging.chunk = make_uniq<DataChunk>();
+		_staging.chunk->Initialize(ChunkAllocator(), _current_chunk->GetTypes());
+		if (_typed) {
+			_staging.typed = make_uniq<TypedObjectBatch>();
+		}
+	}
+	return RowTarget {_staging.chunk.get(), _staging.chunk->size(), true, _staging.typed.get()};
+}
+
+void ITriplesBuffer::SpillStaging() {
+	auto &chunk = *_staging.chunk;
+	if (_staging.typed) {
+		_staging.typed->Decode(chunk, _output_slot + TypedObjectBatch::FIRST_COLUMN, 0, chunk.size());
+	}
+	// Columns no parser writes, such as the file columns the scan fills in, are stored as NULL
+	std::vector<bool> written(chunk.ColumnCount(), false);
+	for (idx_t col = 0; col < COLUMN_COUNT; col++) {
+		if (_output_slot[col] >= 0) {
+			written[_output_slot[col]] = true;
+		}
+	}
+	for (idx_t i = 0; i < chunk.ColumnCount(); i++) {
+		if (!written[i]) {
+			chunk.data[i].Reference(Value(chunk.data[i].GetType()));
+		}
+	}
+	if (!_staged_rows) {
+		auto types = chunk.GetTypes();
+		_staged_rows = _buffer_manager ? make_uniq<ColumnDataCollection>(*_buffer_manager, types)
+		                               : make_uniq<ColumnDataCollection>(Allocator::DefaultAllocator(), types);
+	}
+	_staged_rows->Append(chunk);
+	_staging = StagedChunk();
+}
+
+void ITriplesBuffer::EndRow(const RowTarget &target) {
+	if (target.staged) {
+		target.chunk->SetCardinality(target.row + 1);
+	} else {
+		_current_count++;
+	}
+}
+
+void ITriplesBuffer::WriteTerm(const RowTarget &target, idx_t col, const char *data, idx_t len) {
+	if (_output_slot[col] < 0) {
+		return;
+	}
+	auto &vec = target.chunk->data[_output_slot[col]];
+	// Staged rows are written flat and only go through the dictionary when they are taken
+	auto &dict = _dictionaries[col];
+	if (!target.staged && dict && dict->Active() && dict->Add(vec, target.row, data, len)) {
+		return;
+	}
+	if (!data) {
+		FlatVector::SetNull(vec, target.row, true);
+		return;
+	}
+	if (_mapping && _mapping->Contains(data, len)) {
+		// The string points into the mapped file, which the vector keeps alive
+		if (_mapped_vector[col] != &vec) {
+			StringVector::AddBuffer(vec, _mapping);
+			_mapped_vector[col] = &vec;
+		}
+		FlatVector::GetData<string_t>(vec)[target.row] = string_t(data, (uint32_t)len);
+		return;
+	}
+	FlatVector::GetData<string_t>(vec)[target.row] = StringVector::AddString(vec, data, len);
+}
+
+const char *ITriplesBuffer::CompactIRI(idx_t col, const char *data, idx_t &len) {
+	if (!_compactor || !data) {
+		return data;
+	}
+	auto &last = _compacted[col];
+	if (!last.valid || last.iri.size() != len || memcmp(last.iri.data(), data, len) != 0) {
+		last.iri.assign(data, len);
+		last.compacted = _compactor->Compact(data, len, last.curie);
+		last.valid = true;
+	}
+	if (!last.compacted) {
+		return data;
+	}
+	len = last.curie.size();
+	return last.curie.data();
+}
+
+void ITriplesBuffer::AddFilePrefix(const std::string &name, const std::string &ns) {
+	_compactor->AddPrefix(name, ns, true);
+	for (auto &last : _compacted) {
+		last.valid = false;
+	}
+}
+
+bool ITriplesBuffer::TakeStagedRows(DataChunk &output) {
+	_decoded_rows = 0;
+	std::fill(_mapped_vector, _mapped_vector + 6, nullptr);
+	StagedChunk staged;
+	if (_staged_rows) {
+		// Rows are only staged while none are left to take, so the collection is complete here
+		if (_staged_taken == 0) {
+			_staged_rows->InitializeScan(_staged_scan, ColumnDataScanProperties::DISALLOW_ZERO_COPY);
+		}
+		staged.chunk = make_uniq<DataChunk>();
+		_staged_rows->InitializeScanChunk(*staged.chunk);
+		_staged_rows->Scan(_staged_scan, *staged.chunk);
+		_staged_taken += staged.chunk->size();
+		if (_staged_taken >= _staged_rows->Count()) {
+			_staged_rows.reset();
+			_staged_taken = 0;
+		}
+	} else if (_staging.chunk) {
+		staged = std::move(_staging);
+		_staging = StagedChunk();
+	} else {
+		return true;
+	}
+	auto count = staged.chunk->size();
+	if (staged.typed) {
+		staged.typed->Decode(*staged.chunk, _output_slot + TypedObjectBatch::FIRST_COLUMN, 0, count);
+	}
+	for (idx_t col = 0; col < COLUMN_COUNT; col++) {
+		if (_output_slot[col] < 0) {
+			continue;
+		}
+		auto &source = staged.chunk->data[_output_slot[col]];
+		auto &target = output.data[_output_slot[col]];
+		auto dict = col < 6 ? _dictionaries[col].get() : nullptr;
+		if (!dict || !dict->Active()) {
+			// The output takes over the staged vector's buffers; rows parsed after these are
+			// appended to them
+			target.Reference(source);
+			continue;
+		}
+		auto strings = FlatVector::GetData<string_t>(source);
+		auto &validity = FlatVector::Validity(source);
+		for (idx_t row = 0; row < count; row++) {
+			bool valid = validity.RowIsValid(row);
+			if (!dict->Add(target, row, valid ? strings[row].GetData() : nullptr, valid ? strings[row].GetSize() : 0)) {
+				VectorOperations::Copy(source, target, count, row, row);
+				if (_mapping) {
+					// The copied strings may point into the mapped file
+					StringVector::AddBuffer(target, _mapping);
+				}
+				break;
+			}
+		}
+	}
+	_current_count = count;
+	_decoded_rows = count;
+	return !_staged_rows && !_staging.chunk;
+}
+
+void ITriplesBuffer::FinishChunk(DataChunk &output) {
+	if (_typed) {
+		_typed->Decode(output, _output_slot + TypedObjectBatch::FIRST_COLUMN, _decoded_rows, _current_count);
+	}
+	for (idx_t col = 0; col < 6; col++) {
+		if (_dictionaries[col] && _output_slot[col] >= 0) {
+			_dictionaries[col]->Emit(output.data[_output_slot[col]], _current_count);
+		}
+	}
+	output.SetCardinality(_current_count);
+}
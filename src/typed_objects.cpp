@@ -0,0 +1,202 @@
+#include "include/typed_objects.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
+#include <cstring>
+
+using namespace duckdb;
+
+static const char XSD_PREFIX[] = "http://www.w3.org/2001/XMLSchema#";
+
+struct XSDType {
+	const char *name;
+	RDFObjectKind kind;
+};
+
+static const XSDType XSD_TYPES[] = {
+    {"integer", RDFObjectKind::INTEGER},
+    {"int", RDFObjectKind::INTEGER},
+    {"long", RDFObjectKind::INTEGER},
+    {"short", RDFObjectKind::INTEGER},
+    {"byte", RDFObjectKind::INTEGER},
+    {"nonNegativeInteger", RDFObjectKind::INTEGER},
+    {"nonPositiveInteger", RDFObjectKind::INTEGER},
+    {"negativeInteger", RDFObjectKind::INTEGER},
+    {"positiveInteger", RDFObjectKind::INTEGER},
+    {"unsignedLong", RDFObjectKind::INTEGER},
+    {"unsignedInt", RDFObjectKind::INTEGER},
+    {"unsignedShort", RDFObjectKind::INTEGER},
+    {"unsignedByte", RDFObjectKind::INTEGER},
+    {"decimal", RDFObjectKind::DECIMAL},
+    {"double", RDFObjectKind::DECIMAL},
+    {"float", RDFObjectKind::DECIMAL},
+    {"boolean", RDFObjectKind::BOOLEAN},
+    {"date", RDFObjectKind::DATE},
+    {"dateTime", RDFObjectKind::DATETIME},
+    {"dateTimeStamp", RDFObjectKind::DATETIME},
+};
+
+RDFObjectKind ClassifyDatatype(const char *iri, idx_t len) {
+	const idx_t prefix_len = sizeof(XSD_PREFIX) - 1;
+	if (!iri || len <= prefix_len || memcmp(iri, XSD_PREFIX, prefix_len) != 0) {
+		return RDFObjectKind::NONE;
+	}
+	const char *name = iri + prefix_len;
+	idx_t name_len = len - prefix_len;
+	for (auto &type : XSD_TYPES) {
+		if (strlen(type.name) == name_len && memcmp(type.name, name, name_len) == 0) {
+			return type.kind;
+		}
+	}
+	return RDFObjectKind::NONE;
+}
+
+static const char *const TYPED_COLUMN_NAMES[] = {"object_integer", "object_double", "object_boolean", "object_date",
+                                                   "object_datetime"};
+
+LogicalType TypedObjectBatch::ColumnType(idx_t typed_col) {
+	switch (typed_col) {
+	case 0:
+		return LogicalType::BIGINT;
+	case 1:
+		return LogicalType::DOUBLE;
+	case 2:
+		return LogicalType::BOOLEAN;
+	case 3:
+		return LogicalType::DATE;
+	default:
+		return LogicalType::TIMESTAMP_TZ;
+	}
+}
+
+void TypedObjectBatch::AddColumns(vector<LogicalType> &types, vector<string> &names) {
+	for (idx_t col = 0; col < COLUMN_COUNT; col++) {
+		names.push_back(TYPED_COLUMN_NAMES[col]);
+		types.push_back(ColumnType(col));
+	}
+}
+
+TypedObjectBatch::TypedObjectBatch() {
+	for (idx_t kind = 0; kind < KIND_COUNT; kind++) {
+		_rows[kind].Initialize(STANDARD_VECTOR_SIZE);
+		_counts[kind] = 0;
+	}
+}
+
+void TypedObjectBatch::Add(idx_t row, RDFObjectKind kind, const char *data, idx_t len) {
+	auto k = (idx_t)kind;
+	_lexical[row] = len <= string_t::INLINE_LENGTH ? string_t(data, (uint32_t)len) : _heap.AddBlob(data, len);
+	_rows[k].set_index(_counts[k]++, row);
+}
+
+// Decodes the rows of one kind with DuckDB's cast kernels; unparsable forms stay NULL
+template <class T>
+static void DecodeRows(const SelectionVector &rows, idx_t count, const string_t *lexical, Vector *target) {
+	if (!target) {
+		return;
+	}
+	auto data = FlatVector::GetData<T>(*target);
+	auto &validity = FlatVector::Validity(*target);
+	for (idx_t i = 0; i < count; i++) {
+		auto row = rows.get_index(i);
+		if (TryCast::Operation<string_t, T>(lexical[row], data[row], false)) {
+			validity.SetValid(row);
+		}
+	}
+}
+
+// xsd:boolean only allows these four forms, fewer than a VARCHAR to BOOLEAN cast accepts
+static bool ParseXSDBoolean(const string_t &lexical, bool &result) {
+	auto data = lexical.GetData();
+	auto len = lexical.GetSize();
+	if ((len == 4 && memcmp(data, "true", 4) == 0) || (len == 1 && data[0] == '1')) {
+		result = true;
+		return true;
+	}
+	if ((len == 5 && memcmp(data, "false", 5) == 0) || (len == 1 && data[0] == '0')) {
+		result = false;
+		return true;
+	}
+	return false;
+}
+
+void TypedObjectBatch::Decode(DataChunk &chunk, const int8_t *slots, idx_t start, idx_t end) {
+	Vector *targets[COLUMN_COUNT];
+	for (idx_t col = 0; col < COLUMN_COUNT; col++) {
+		targets[col] = slots[col] >= 0 ? &chunk.data[slots[col]] : nullptr;
+		if (targets[col]) {
+			auto &validity = FlatVector::Validity(*targets[col]);
+			for (idx_t row = start; row < end; row++) {
+				validity.SetInvalid(row);
+			}
+		}
+	}
+
+	// Integers also fill object_double, so every numeric literal can be read from one column
+	auto &integers = _rows[(idx_t)RDFObjectKind::INTEGER];
+	auto integer_count = _counts[(idx_t)RDFObjectKind::INTEGER];
+	DecodeRows<int64_t>(integers, integer_count, _lexical, targets[0]);
+	DecodeRows<double>(integers, integer_count, _lexical, targets[1]);
+	DecodeRows<double>(_rows[(idx_t)RDFObjectKind::DECIMAL], _counts[(idx_t)RDFObjectKind::DECIMAL], _lexical,
+	                   targets[1]);
+	if (targets[2]) {
+		auto &rows = _rows[(idx_t)RDFObjectKind::BOOLEAN];
+		auto data = FlatVector::GetData<bool>(*targets[2]);
+		auto &validity = FlatVector::Validity(*targets[2]);
+		for (idx_t i = 0; i < _counts[(idx_t)RDFObjectKind::BOOLEAN]; i++) {
+			auto row = rows.get_index(i);
+			if (ParseXSDBoolean(_lexical[row], data[row])) {
+				validity.SetValid(row);
+			}
+		}
+	}
+	DecodeRows<date_t>(_rows[(idx_t)RDFObjectKind::DATE], _counts[(idx_t)RDFObjectKind::DATE], _lexical, targets[3]);
+	DecodeRows<timestamp_t>(_rows[(idx_t)RDFObjectKind::DATETIME], _counts[(idx_t)RDFObjectKind::DATETIME], _lexical,
+	                        targets[4]);
+
+	for (idx_t kind = 0; kind < KIND_COUNT; kind++) {
+		_counts[kind] = 0;
+	}
+	_heap.Destroy();
+}
+
+Value TypedObjectBatch::DecodeValue(idx_t typed_col, RDFObjectKind kind, const char *data, idx_t len) {
+	string_t lexical(data, (uint32_t)len);
+	switch (typed_col) {
+	case 0: {
+		int64_t result;
+		if (kind == RDFObjectKind::INTEGER && TryCast::Operation<string_t, int64_t>(lexical, result, false)) {
+			return Value::BIGINT(result);
+		}
+		break;
+	}
+	case 1: {
+		double result;
+		if ((kind == RDFObjectKind::INTEGER || kind == RDFObjectKind::DECIMAL) &&
+		    TryCast::Operation<string_t, double>(lexical, result, false)) {
+			return Value::DOUBLE(result);
+		}
+		break;
+	}
+	case 2: {
+		bool result;
+		if (kind == RDFObjectKind::BOOLEAN && ParseXSDBoolean(lexical, result)) {
+			return Value::BOOLEAN(result);
+		}
+		break;
+	}
+	case 3: {
+		date_t result;
+		if (kind == RDFObjectKind::DATE && TryCast::Operation<string_t, date_t>(lexical, result, false)) {
+			return Value::DATE(result);
+		}
+		break;
+	}
+	default: {
+		timestamp_t result;
+		if (kind == RDFObjectKind::DATETIME && TryCast::Operation<string_t, timestamp_t>(lexical, result, false)) {
+			return Value::TIMESTAMPTZ(timestamp_tz_t(result));
+		}
+		break;
+	}
+	}
+	return Value(ColumnType(typed_col));
+}
@@ -13,93 +13,122 @@ XMLBuffer::XMLBuffer(std::string path, std::string base_uri, duckdb::FileSystem
 	}
 	this->_fs = fs;
 	try {
-		this->_file_handle = this->_fs->OpenFile(this->_file_path, duckdb::FileFlags::FILE_FLAGS_READ);
+		this->_file_handle = OpenRDFInput(*this->_fs, this->_file_path, this->_compression);
 	} catch (std::exception &ex) {
 		throw std::runtime_error("Could not open RDF file: " + this->_file_path + ": " + ex.what());
 	}
 	_parser.setBlankNodePrefix("genid");
 }
 XMLBuffer::~XMLBuffer() {
+	// Stop reading ahead before the file handle goes away
+	_read_ahead.reset();
+	if (_charged_text > 0) {
+		_buffer_manager->FreeReservedMemory(_charged_text);
+	}
 }
 
 void XMLBuffer::PopulateChunk(duckdb::DataChunk &output) {
 	_current_chunk = &output;
 	_current_count = 0;
-	while (!_overflow_buffer.empty() && _current_count < STANDARD_VECTOR_SIZE) {
-		RDFRow row = _overflow_buffer.front();
-		_overflow_buffer.pop_front();
-		// Manual copy from string to vector (slow path)
-		if (_output_slot[0] >= 0)
-			output.SetValue(_output_slot[0], _current_count, duckdb::Value(row.graph));
-		if (_output_slot[1] >= 0)
-			output.SetValue(_output_slot[1], _current_count, duckdb::Value(row.subject));
-		if (_output_slot[2] >= 0)
-			output.SetValue(_output_slot[2], _current_count, duckdb::Value(row.predicate));
-		if (_output_slot[3] >= 0)
-			output.SetValue(_output_slot[3], _current_count, duckdb::Value(row.object));
-		if (_output_slot[4] >= 0)
-			output.SetValue(_output_slot[4], _current_count, duckdb::Value(row.datatype));
-		if (_output_slot[5] >= 0)
-			output.SetValue(_output_slot[5], _current_count, duckdb::Value(row.lang));
-		_current_count++;
+	if (_filter) {
+		_filter->Refresh();
 	}
+	// Rows staged while the previous chunk was full come first
+	bool can_parse = TakeStagedRows(output);
 
-	char buffer[PARSING_CHUNK_SIZE];
-	while (_current_count < STANDARD_VECTOR_SIZE && !_eof) {
-		// Read up to PARSING_CHUNK_SIZE bytes via DuckDB FileHandle
-		int64_t res = _file_handle->Read(buffer, PARSING_CHUNK_SIZE);
+	while (can_parse && _current_count < STANDARD_VECTOR_SIZE && !_eof) {
+		// Read up to PARSING_CHUNK_SIZE bytes from the blocks read ahead of the parser
+		idx_t res = _read_ahead->Read(_chunk.data(), PARSING_CHUNK_SIZE);
 		if (res < PARSING_CHUNK_SIZE) {
 			_eof = true;
 		}
-		_parser.parseChunk(buffer, (int)res, _eof);
+		_parser.parseChunk(_chunk.data(), (int)res, _eof);
+		chargeText();
 	}
-	output.SetCardinality(_current_count);
+	FinishChunk(output);
 	_current_chunk = nullptr;
 }
+
+void XMLBuffer::chargeText() {
+	if (!_buffer_manager) {
+		return;
+	}
+	idx_t held = _parser.bufferedText();
+	if (held > _charged_text) {
+		// Evicts other buffers to disk, or fails the scan once the limit is reached
+		_buffer_manager->ReserveMemory(held - _charged_text);
+	} else if (held < _charged_text) {
+		_buffer_manager->FreeReservedMemory(_charged_text - held);
+	}
+	_charged_text = held;
+}
 void XMLBuffer::StartParse() {
+	_input_reader = std::unique_ptr<RDFInputReader>(new RDFInputReader(*_file_handle, _compression));
+	auto reader = _input_reader.get();
+	auto source = [reader](char *buf, idx_t len) { return reader->Read(buf, len); };
+	_read_ahead = std::unique_ptr<ReadAheadBuffer>(new ReadAheadBuffer(source, _buffer_size));
+	_chunk.resize(PARSING_CHUNK_SIZE);
 }
 
-void XMLBuffer::writeToVector(duckdb::Vector &vec, idx_t row_idx, const std::string &field) {
-	if (field.empty()) {
-		duckdb::FlatVector::SetNull(vec, row_idx, true);
-		return;
+bool XMLBuffer::passesFilter(const RdfStatement &stmt, const char *const data[6], const idx_t len[6]) const {
+	for (idx_t col = 0; col < 6; col++) {
+		if (_filter->HasFilter(col) && !_filter->Matches(col, data[col], len[col])) {
+			return false;
+		}
 	}
+	return true;
+}
 
-	auto str = duckdb::StringVector::AddString(vec, field);
-	duckdb::FlatVector::GetData<duckdb::string_t>(vec)[row_idx] = str;
+static bool IsBlankNode(const std::string &term) {
+	return term.size() >= 2 && term[0] == '_' && term[1] == ':';
 }
+
 void XMLBuffer::statementCallback(const RdfStatement &stmt) {
-	// Safety check: If chunk is full, push to overflow and return
-	if (_current_count >= STANDARD_VECTOR_SIZE) {
-		RDFRow row;
-		row.subject = stmt.subject;
-		row.predicate = stmt.predicate;
-		row.object = stmt.object;
-		row.graph = "";
-		row.datatype = stmt.datatype;
-		row.lang = stmt.language;
-		_overflow_buffer.push_back(std::move(row));
+	if (SkipSample()) {
 		return;
 	}
-	// Fast path with slot mapping
-	const int8_t *slots = _output_slot;
-	if (slots[0] >= 0)
-		writeToVector(_current_chunk->data[slots[0]], _current_count, "");
-	if (slots[1] >= 0)
-		writeToVector(_current_chunk->data[slots[1]], _current_count, stmt.subject);
-	if (slots[2] >= 0)
-		writeToVector(_current_chunk->data[slots[2]], _current_count, stmt.predicate);
-	if (slots[3] >= 0)
-		writeToVector(_current_chunk->data[slots[3]], _current_count, stmt.object);
-	if (slots[4] >= 0)
-		writeToVector(_current_chunk->data[slots[4]], _current_count, stmt.datatype);
-	if (slots[5] >= 0)
-		writeToVector(_current_chunk->data[slots[5]], _current_count, stmt.language);
-	_current_count++;
+	if (CountOnly()) {
+		CountRow();
+		return;
+	}
+	// Empty fields are NULL; RDF/XML has no graphs
+	const std::string *terms[6] = {nullptr, &stmt.subject, &stmt.predicate, &stmt.object, &stmt.datatype, &stmt.language};
+	const char *data[6];
+	idx_t len[6];
+	for (idx_t col = 0; col < 6; col++) {
+		bool valid = terms[col] && !terms[col]->empty();
+		data[col] = valid ? terms[col]->data() : nullptr;
+		len[col] = valid ? terms[col]->size() : 0;
+	}
+	if (_compactor) {
+		if (!IsBlankNode(stmt.subject)) {
+			data[1] = CompactIRI(1, data[1], len[1]);
+		}
+		data[2] = CompactIRI(2, data[2], len[2]);
+		if (!stmt.literal && !IsBlankNode(stmt.object)) {
+			data[3] = CompactIRI(3, data[3], len[3]);
+		}
+		data[4] = CompactIRI(4, data[4], len[4]);
+	}
+	if (_filter && !passesFilter(stmt, data, len)) {
+		return;
+	}
+	auto target = BeginRow();
+	for (idx_t col = 0; col < 6; col++) {
+		WriteTerm(target, col, data[col], len[col]);
+	}
+	if (target.typed && !stmt.datatype.empty()) {
+		WriteTypedObject(target, ClassifyDatatype(stmt.datatype.data(), stmt.datatype.size()), stmt.object.data(),
+		                 stmt.object.size());
+	}
+	EndRow(target);
 }
 
 void XMLBuffer::namespaceCallback(const std::string &prefix, const std::string &uri) {
 	_parser.addNameSpace(prefix, uri);
+	if (_compactor) {
+		AddFilePrefix(prefix, uri);
+	}
 }
 void XMLBuffer::errorCallback(const std::string &msg) {
 	throw duckdb::SyntaxException("Error: " + msg);
@@ -0,0 +1,258 @@
+#include "include/zone_index.hpp"
+#include "include/ntriples_tokenizer.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+using namespace duckdb;
+
+static const char INDEX_MAGIC[] = "RDFZIDX1";
+static const char INDEX_END_MAGIC[] = "RDFZEND1";
+static constexpr idx_t MAGIC_SIZE = 8;
+// Bytes read from the file at a time while building
+static constexpr idx_t BUILD_READ_SIZE = 1024 * 1024;
+
+template <class T>
+static void AppendValue(std::string &out, T value) {
+	out.append((const char *)&value, sizeof(T));
+}
+
+static void AppendTerm(std::string &out, const std::string &term) {
+	AppendValue<uint32_t>(out, (uint32_t)term.size());
+	out += term;
+}
+
+// Reads values from an index file, checking they lie within it
+class IndexReader {
+public:
+	IndexReader(const char *data, idx_t size) : _data(data), _size(size) {
+	}
+
+	template <class T>
+	T Read() {
+		T value;
+		memcpy(&value, Take(sizeof(T)), sizeof(T));
+		return value;
+	}
+	const char *Take(idx_t len) {
+		if (len > _size - _pos) {
+			throw std::runtime_error("Corrupt zone index file");
+		}
+		auto result = _data + _pos;
+		_pos += len;
+		return result;
+	}
+	std::string ReadTerm() {
+		auto len = Read<uint32_t>();
+		return std::string(Take(len), len);
+	}
+	idx_t Remaining() const {
+		return _size - _pos;
+	}
+
+private:
+	const char *_data;
+	idx_t _size;
+	idx_t _pos = 0;
+};
+
+// The size and modification time an index must have been built from
+static std::string SerializeHeader(FileSystem &fs, const std::string &source_path, bool quads) {
+	auto handle = fs.OpenFile(source_path, FileFlags::FILE_FLAGS_READ);
+	std::string header(INDEX_MAGIC, MAGIC_SIZE);
+	AppendValue<uint64_t>(header, (uint64_t)MaxValue<int64_t>(fs.GetFileSize(*handle), 0));
+	AppendValue<int64_t>(header, fs.GetLastModifiedTime(*handle).value);
+	AppendValue<uint8_t>(header, quads ? 1 : 0);
+	return header;
+}
+
+static void Widen(std::string &min, std::string &max, const char *data, idx_t len, bool first) {
+	std::string term(data, len);
+	if (first || term < min) {
+		min = term;
+	}
+	if (first || term > max) {
+		max = std::move(term);
+	}
+}
+
+unique_ptr<ZoneIndex> ZoneIndex::Open(FileSystem &fs, const std::string &source_path, bool quads) {
+	auto index_path = IndexPath(source_path);
+	try {
+		if (!fs.FileExists(index_path)) {
+			return nullptr;
+		}
+		auto expected = SerializeHeader(fs, source_path, quads);
+		auto handle = fs.OpenFile(index_path, FileFlags::FILE_FLAGS_READ);
+		auto size = (idx_t)MaxValue<int64_t>(fs.GetFileSize(*handle), 0);
+		if (size < expected.size() + sizeof(uint64_t) + MAGIC_SIZE) {
+			return nullptr;
+		}
+		std::vector<char> data(size);
+		handle->Read(data.data(), size, 0);
+		if (memcmp(data.data(), expected.data(), expected.size()) != 0 ||
+		    memcmp(data.data() + size - MAGIC_SIZE, INDEX_END_MAGIC, MAGIC_SIZE) != 0) {
+			return nullptr; // the index of another version of the file, or an incomplete one
+		}
+		IndexReader reader(data.data() + expected.size(), size - expected.size() - MAGIC_SIZE);
+		auto block_count = reader.Read<uint64_t>();
+		auto result = make_uniq<ZoneIndex>();
+		idx_t previous_end = 0;
+		for (idx_t i = 0; i < block_count; i++) {
+			ZoneIndexBlock block;
+			block.start = reader.Read<uint64_t>();
+			block.end = reader.Read<uint64_t>();
+			block.statements = reader.Read<uint64_t>();
+			block.bounded = reader.Read<uint8_t>() != 0;
+			block.min_subject = reader.ReadTerm();
+			block.max_subject = reader.ReadTerm();
+			block.min_predicate = reader.ReadTerm();
+			block.max_predicate = reader.ReadTerm();
+			if (block.start != previous_end || block.end <= block.start) {
+				return nullptr;
+			}
+			previous_end = block.end;
+			result->blocks.push_back(std::move(block));
+		}
+		if (reader.Remaining() != 0) {
+			return nullptr;
+		}
+		return result;
+	} catch (std::exception &) {
+		// An unreadable index is ignored; rdf_build_index writes it again
+		return nullptr;
+	}
+}
+
+unique_ptr<ZoneIndex> ZoneIndex::Build(FileSystem &fs, const std::string &source_path, bool quads, idx_t block_size) {
+	auto header = SerializeHeader(fs, source_path, quads);
+	auto handle = fs.OpenFile(source_path, FileFlags::FILE_FLAGS_READ);
+	auto result = make_uniq<ZoneIndex>();
+	NTriplesTokenizer tokenizer(quads);
+	NTriplesStatement stmt;
+	ZoneIndexBlock block;
+	// The block's bounds hold a statement
+	bool has_bounds = false;
+	// File offset of the first byte of buffer, which holds the start of a line
+	idx_t position = 0;
+	std::vector<char> buffer;
+	bool done = false;
+	auto end_block = [&](idx_t end) {
+		block.end = end;
+		result->blocks.push_back(std::move(block));
+		block = ZoneIndexBlock();
+		block.start = end;
+		has_bounds = false;
+	};
+	while (!done) {
+		buffer.resize(buffer.size() + BUILD_READ_SIZE);
+		auto read = handle->Read(buffer.data() + buffer.size() - BUILD_READ_SIZE, BUILD_READ_SIZE);
+		buffer.resize(buffer.size() - BUILD_READ_SIZE + (idx_t)MaxValue<int64_t>(read, 0));
+		done = read <= 0;
+		const char *data = buffer.data();
+		const char *data_end = data + buffer.size();
+		const char *line = data;
+		while (line < data_end) {
+			bool plain = true;
+			auto line_end = NTriplesTokenizer::FindLineEnd(line, data_end, plain);
+			if (line_end == data_end && !done) {
+				break;
+			}
+			auto result_type = plain ? tokenizer.Tokenize(line, line_end, stmt) : NTriplesTokenizer::Result::FALLBACK;
+			if (!plain) {
+				// Blank and comment lines are not statements whatever bytes they hold
+				auto first = line;
+				while (first < line_end && (*first == ' ' || *first == '\t' || *first == '\r')) {
+					first++;
+				}
+				if (first == line_end || *first == '#') {
+					result_type = NTriplesTokenizer::Result::EMPTY;
+				}
+			}
+			if (result_type == NTriplesTokenizer::Result::STATEMENT) {
+				Widen(block.min_subject, block.max_subject, stmt.data[1], stmt.len[1], !has_bounds);
+				Widen(block.min_predicate, block.max_predicate, stmt.data[2], stmt.len[2], !has_bounds);
+				has_bounds = true;
+				block.statements++;
+			} else if (result_type == NTriplesTokenizer::Result::FALLBACK) {
+				block.bounded = false;
+				block.statements++;
+			}
+			line = line_end < data_end ? line_end + 1 : data_end;
+			idx_t line_offset = position + (idx_t)(line - data);
+			if (line_offset - block.start >= block_size) {
+				end_block(line_offset);
+			}
+		}
+		auto offset = (idx_t)(line - data);
+		position += offset;
+		buffer.erase(buffer.begin(), buffer.begin() + (int64_t)offset);
+	}
+	if (position > block.start) {
+		end_block(position);
+	}
+	if (position == 0) {
+		throw InvalidInputException("Can't index an empty file: " + source_path);
+	}
+
+	std::string index = header;
+	AppendValue<uint64_t>(index, result->blocks.size());
+	for (auto &b : result->blocks) {
+		AppendValue<uint64_t>(index, b.start);
+		AppendValue<uint64_t>(index, b.end);
+		AppendValue<uint64_t>(index, b.statements);
+		AppendValue<uint8_t>(index, b.bounded ? 1 : 0);
+		AppendTerm(index, b.min_subject);
+		AppendTerm(index, b.max_subject);
+		AppendTerm(index, b.min_predicate);
+		AppendTerm(index, b.max_predicate);
+	}
+	index.append(INDEX_END_MAGIC, MAGIC_SIZE);
+
+	auto index_path = IndexPath(source_path);
+	std::random_device random;
+	auto temp_path = index_path + StringUtil::Format(".%08x.tmp", (unsigned)random());
+	try {
+		auto out = fs.OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		out->Write((void *)index.data(), index.size(), 0);
+		out->Sync();
+		out->Close();
+		out.reset();
+		fs.MoveFile(temp_path, index_path);
+	} catch (std::exception &) {
+		try {
+			fs.RemoveFile(temp_path);
+		} catch (std::exception &) {
+		}
+		throw;
+	}
+	return result;
+}
+
+idx_t ZoneIndex::StatementCount() const {
+	idx_t count = 0;
+	for (auto &block : blocks) {
+		count += block.statements;
+	}
+	return count;
+}
+
+bool ZoneIndex::SubjectsSorted() const {
+	// Blocks of comments and blank lines have no subjects
+	const std::string *previous_max = nullptr;
+	for (auto &block : blocks) {
+		if (!block.bounded) {
+			return false;
+		}
+		if (block.statements == 0) {
+			continue;
+		}
+		if (previous_max && block.min_subject < *previous_max) {
+			return false;
+		}
+		previous_max = &block.max_subject;
+	}
+	return true;
+}